@@ -38,6 +38,17 @@ struct cmd_arguments
     /* x? */
 // Refinement specifications:
     /* y, z? */
+// Pipeline:
+    /* --streaming */ bool streaming = false;
+// Regions:
+    /* --region */ std::vector<std::string> regions{};
+    /* --regions_bed */ std::filesystem::path regions_bed_file_path{};
+// Input from a previous run:
+    /* --input_junctions */ std::filesystem::path input_junctions_file_path{};
+// Short read variants:
+    /* --snp_indel */ bool snp_indel_detection = false;
+// Clustering of large partitions:
+    /* --approximate_large_partitions */ bool approximate_large_partitions = false;
 };
 
 void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments & args);
@@ -48,9 +59,16 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
  * \param[in] args - command line arguments:\n
  *                   **args.alignment_short_reads_file_path** - short reads input file, path to the sam/bam file\n
  *                   **args.alignment_long_reads_file_path** - long reads input file, path to the sam/bam file\n
+ *                   **args.genome_file_path** - reference genome input file, path to the FASTA file, which fills the
+ *                                               REF column of the VCF output\n
+ *                   **args.snp_indel_detection** - detect SNPs and indels instead of junctions in the short reads
+ *                                                  - *default: false*\n
+ *                   **args.input_junctions_file_path** - junctions input file, path to a dump of a previous run,
+ *                                                        which replaces the alignment files\n
  *                   **args.output_file_path** output file - path for the VCF file - *default: standard output*\n
  *                   **args.vcf_sample_name - Name of the sample for the vcf header line*\n
- *                   **args.threads - The number of decompression threads used for reading BAM files.*\n
+ *                   **args.threads - The number of threads used for reading BAM files, for analysing the long
+ *                                    read alignments, for clustering and for formatting the VCF records.*\n
  *                   **args.methods** - list of methods for detecting junctions
  *                      (1: cigar_string, 2: split_read, 3: read_pairs, 4: read_depth) - *default: all methods*\n
  *                   **args.clustering_method** - method for clustering junctions
@@ -73,7 +91,11 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
  *                   **args.min_qual** - minimum quality (amount of supporting reads) of a structural variant
  *                                       (expected to be non-negative) - *default: 1 supporting read*\n
  *                   **args.hierarchical_clustering_cutoff** - distance cutoff for the hierarchical clustering
- *                                                             (expected to be non-negative) - *default: 10*
+ *                                                             (expected to be non-negative) - *default: 10*\n
+ *                   **args.approximate_large_partitions** - cluster large components of the partitions by a sparse
+ *                                                           average linkage in the hierarchical clustering
+ *                                                           - *default: false*\n
+ *                   **args.streaming** - process the long read file in streaming mode - *default: false*
  *
  *
  * \details Detects novel junctions from read alignment records using different detection methods.
@@ -81,7 +103,22 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
  *          Then, the junction clusters are refined using one of several refinement methods.
  *          Finally, the refined junction clusters are categorized into different variant classes
  *          and output in VCF format.
+ *          If **args.streaming** is set, detect_variants_in_long_reads_file_streaming() is used instead.
  */
 void detect_variants_in_alignment_file(cmd_arguments const & args);
 
+/*! \brief Detects genomic variants in a long read alignment file (sam/bam) in streaming mode. The junctions are
+ *         detected and spilled to a temporary file in sorted runs, then clustered and output in batches, such that
+ *         the peak memory depends on the size of the runs and batches and not on the whole genome.
+ *
+ * \param[in] args - command line arguments, see detect_variants_in_alignment_file(). Only
+ *                   **args.alignment_long_reads_file_path** is used as input.
+ *
+ * \details The batches are formed by stream_junctions_in_long_reads_sam_file(). They are sorted like the junctions of
+ *          detect_variants_in_alignment_file() and contain whole partitions, thus the VCF records are sorted and the
+ *          clusters are the same as in batch mode. Only the candidate selection based on voting does not cluster
+ *          within partitions, thus its clusters can differ from batch mode at the borders of the batches.
+ */
+void detect_variants_in_long_reads_file_streaming(cmd_arguments const & args);
+
 int main(int argc, char ** argv);
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "structures/cluster.hpp"   // for class Cluster
+
+/*! \brief Cluster junctions by letting each junction vote for a bucket of quantized coordinates and selecting the local
+ *         maxima of the votes as candidate variants.
+ *         The returned clusters and the junctions in each returned cluster are sorted.
+ *
+ * \param[in] junctions - a vector of junctions
+ * \param[in] clustering_cutoff - width of the buckets in units of the junction_distance()
+ *
+ * \returns Returns sorted clusters of sorted junctions.
+ *
+ * \details The buckets are formed per class of junctions (see sv_class()), i.e. per reference sequences, orientations
+ *          and type. Intra-chromosomal junctions are quantized by the first mate position in kbp and the logarithm of
+ *          the directed size, inter-chromosomal junctions by both mate positions in kbp, each with a width of
+ *          clustering_cutoff. The votes are counted in a flat hash table. Each bucket points to the bucket with the
+ *          most votes among itself and its 8 neighbours (the smaller one on ties) and the junctions of all buckets,
+ *          which lead to the same local maximum, form a cluster. The runtime is linear in the number of junctions.
+ *          With a cutoff of 0 each junction forms its own cluster, like in the hierarchical clustering.
+ */
+std::vector<Cluster> candidate_selection_based_on_voting_method(std::vector<Junction> const & junctions,
+                                                                double const clustering_cutoff);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>                     // for std::span
+
 #include "structures/cluster.hpp"   // for class Cluster
 
 /*! \brief Partition junctions by their distance on the reference genome.
@@ -10,27 +12,51 @@
  *            smaller or equal than the given partition_max_distance.
  *         The junctions in each of the returned partitions are sorted even though
  *         the partitions themselves are not returned in a particular order.
+ *         The junctions are not copied: they are reordered in place, such that each partition is a contiguous range
+ *         of `junctions`.
  *
- * \param[in] junctions - a vector of junctions (needs to be sorted)
+ * \param[in,out] junctions - a vector of junctions (needs to be sorted), reordered in place
  * \param[in] partition_max_distance - maximum distance between junctions in the same partition
  *
- * \returns Returns unordered partitions of sorted junctions.
+ * \returns Returns unordered partitions of sorted junctions as views into `junctions`.
  */
-std::vector<std::vector<Junction>> partition_junctions(std::vector<Junction> const & junctions,
-                                                       int32_t const partition_max_distance);
+std::vector<std::span<Junction>> partition_junctions(std::vector<Junction> & junctions,
+                                                     int32_t const partition_max_distance);
 
 /*! \brief Sub-partition an existing partition based on the second mate of each junction.
  *         The junctions in each of the returned sub-partitions are sorted even though
  *         the sub-partitions themselves are not returned in a particular order.
+ *         The junctions of the partition are reordered in place.
  *
- * \param[in] partition - a partition (i.e. a vector) of junctions (needs to be sorted
- *                        by their second mates)
+ * \param[in] partition - a partition (i.e. a range) of junctions
  * \param[in] partition_max_distance - maximum distance between junctions in the same partition
  *
  * \returns Returns unordered sub-partitions of sorted junctions based on the second mate of each junction.
  */
-std::vector<std::vector<Junction>> split_partition_based_on_mate2(std::vector<Junction> const & partition,
-                                                                  int32_t const partition_max_distance);
+std::vector<std::span<Junction>> split_partition_based_on_mate2(std::span<Junction> const partition,
+                                                                int32_t const partition_max_distance);
+
+/*! \brief Returns the class of a junction, junctions of different classes have the maximal junction_distance().
+ *
+ * \param[in] junction - the junction to classify
+ *
+ * \returns Returns -1 for intra-chromosomal junctions with a negative directed size (deletions and inversions), 1 for a
+ *          positive directed size (insertions), 0 for a directed size of 0 and 2 for inter-chromosomal junctions.
+ *          Junctions of class 0 have the maximal distance to all junctions, including each other.
+ */
+int32_t sv_class(Junction const & junction);
+
+/*! \brief Sub-partition an existing partition based on the class of each junction, i.e. deletions, insertions and
+ *         inter-chromosomal junctions. Junctions of different classes have the maximal distance to each other.
+ *         Junctions with a directed size of 0 have the maximal distance to all junctions and form a sub-partition
+ *         each. The junctions of the partition are reordered in place and are sorted in each of the returned
+ *         sub-partitions.
+ *
+ * \param[in] partition - a partition (i.e. a range) of junctions
+ *
+ * \returns Returns unordered sub-partitions of junctions of the same class.
+ */
+std::vector<std::span<Junction>> split_partition_by_sv_class(std::span<Junction> const partition);
 
 /*! \brief Compute the distance between two junctions.
  *         For two junctions that connect the same reference sequences and have the same
@@ -45,18 +71,61 @@ std::vector<std::vector<Junction>> split_partition_based_on_mate2(std::vector<Ju
  */
 double junction_distance(Junction const & lhs, Junction const & rhs);
 
+/*! \brief Average linkage clustering of a condensed distance matrix, which stops merging at the clustering cutoff.
+ *         Without ties between distances, the labels are identical to the ones of hclust_fast() with
+ *         HCLUST_METHOD_AVERAGE and cutree_cdist() with the same cutoff.
+ *
+ * \param[in] size - the number of elements
+ * \param[in, out] distances - the condensed distance matrix (upper triangle of the full distance matrix), which is
+ *                             overwritten
+ * \param[in] clustering_cutoff - clusters with an average distance smaller than this cutoff are merged
+ *
+ * \returns Returns the cluster label of each element. The labels are numbered in the order of the first element of each
+ *          cluster.
+ *
+ * \details The clusters are merged by the nearest-neighbour chain algorithm. A cluster, whose nearest neighbour is at
+ *          least clustering_cutoff away, is final and is not scanned anymore, thus partitions that split into many
+ *          small clusters need less work than the complete dendrogram.
+ *          A merged cluster is represented by its first element and a new chain starts at the cluster with the
+ *          smallest first element. Of several equally near neighbours, the previous cluster of the chain is chosen
+ *          and otherwise the one with the smallest first element, e.g. the elements at the positions 0, 1 and 2 are
+ *          clustered into {0, 1} and {2}. hclust_fast() does not stop at the cutoff and merges into other clusters,
+ *          thus it may break such ties differently.
+ */
+std::vector<size_t> bounded_average_linkage(size_t const size,
+                                            std::vector<double> & distances,
+                                            double const clustering_cutoff);
+
 /*! \brief Cluster junctions by an hierarchical clustering method.
  *         The returned clusters and the junctions in each returned cluster are sorted.
  *
- * \param[in] junctions - a vector of junctions (needs to be sorted)
+ * \param[in] junctions - a vector of junctions (needs to be sorted), moved into the clusters
  * \param[in] partition_max_distance - maximum distance between junctions in the same partition
  * \param[in] clustering_cutoff - distance cutoff for clustering
+ * \param[in] threads - number of threads used for clustering the partitions concurrently
+ * \param[in] approximate_large_components - cluster components with more than 200 junctions by the sparse average
+ *                                           linkage instead of the full distance matrix
  *
  * \returns Returns sorted clusters of sorted junctions.
  *
- * \details For the algorithms we use the library hclust.
+ * \details The junctions of each partition are clustered by bounded_average_linkage(), an average linkage
+ *          clustering like the one of the library hclust, which stops at the clustering cutoff.
+ *          The partitions are independent of each other. They are handed out to the threads largest first and the
+ *          result is identical for any number of threads.
+ *          Partitions with more than 200 junctions are not clustered with a full distance matrix. They are decomposed
+ *          into the connected components of junctions closer than the cutoff, found on a grid of the junction
+ *          coordinates. Average linkage never merges two components, so each component is clustered with its own
+ *          distance matrix and the result is the same as with the distance matrix of the whole partition. The memory
+ *          of the distance matrix grows quadratically with the size of a component. If approximate_large_components
+ *          is set, components with more than 200 junctions are clustered by a sparse average linkage over the pairs
+ *          in the neighbourhood instead. It is an approximation: it starts with micro-clusters of nearby junctions
+ *          and counts the pairs of junctions, which are not in neighbouring grid cells and thus at least twice the
+ *          cutoff apart, as exactly twice the cutoff apart. It may merge clusters, which the average linkage over the
+ *          full distance matrix keeps apart, and split others.
  * \see https://lionel.kr.hs-niederrhein.de/~dalitz/data/hclust/ (last access 01.06.2021).
  */
-std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> const & junctions,
+std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> junctions,
                                                     int32_t const partition_max_distance,
-                                                    double clustering_cutoff);
+                                                    double clustering_cutoff,
+                                                    size_t const threads = 1,
+                                                    bool const approximate_large_components = false);
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <map>                      // for std::multimap
+#include <tuple>                    // for std::tuple
+
+#include "structures/cluster.hpp"   // for class Cluster
+
+/*! \brief An online clusterer, which inserts junctions one by one into a self-balancing binary search tree of cluster
+ *         centroids and merges each junction into the nearest centroid.
+ *
+ * \details The centroids are ordered by the reference sequences and orientations of their mates, the class of the
+ *          junctions (see sv_class()) and the average position of their first mates. For a new junction, the
+ *          centroids of the same references, orientations and class with a first mate position at most
+ *          partition_max_distance apart are compared. The junction is merged into the nearest of them, if the
+ *          junction_distance() to its average junction is smaller than the clustering cutoff, otherwise it becomes a
+ *          new centroid. Each insertion takes O(log n) plus the number of compared centroids and no distance matrix
+ *          is stored.
+ *          The clusters depend on the order of insertion, thus the junctions should be inserted in sorted order for
+ *          reproducible results. The split reads yield junctions out of this order, thus the junctions are not
+ *          inserted while they are detected, but per sorted batch of the streaming mode (see
+ *          stream_junctions_in_long_reads_sam_file()) or after the detection.
+ */
+class SelfBalancingBinaryTreeClusterer
+{
+private:
+    //! \brief Reference sequences and orientations of both mates, class and average position of the first mate.
+    using centroid_key_t = std::tuple<InternedString, strand, InternedString, strand, int32_t, int32_t>;
+
+    //! \brief The members of a cluster and the sums of their coordinates.
+    struct Centroid
+    {
+        std::vector<Junction> members{};
+        int64_t sum_mate1_positions{0};
+        int64_t sum_mate2_positions{0};
+        int64_t sum_inserted_sizes{0};
+    };
+
+    std::multimap<centroid_key_t, Centroid> centroids{};
+    int32_t partition_max_distance{};
+    double clustering_cutoff{};
+
+    //! \brief The junction_distance() of a junction to the average junction of a centroid of the same class.
+    static double centroid_distance(Junction const & junction, Centroid const & centroid, int32_t const junction_class);
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    SelfBalancingBinaryTreeClusterer()                                                     = default; //!< Defaulted.
+    SelfBalancingBinaryTreeClusterer(SelfBalancingBinaryTreeClusterer const &)             = default; //!< Defaulted.
+    SelfBalancingBinaryTreeClusterer(SelfBalancingBinaryTreeClusterer &&)                  = default; //!< Defaulted.
+    SelfBalancingBinaryTreeClusterer & operator=(SelfBalancingBinaryTreeClusterer const &) = default; //!< Defaulted.
+    SelfBalancingBinaryTreeClusterer & operator=(SelfBalancingBinaryTreeClusterer &&)      = default; //!< Defaulted.
+    ~SelfBalancingBinaryTreeClusterer()                                                    = default; //!< Defaulted.
+
+    /*! \brief Construct an empty clusterer.
+     *
+     * \param[in] partition_max_distance - maximum distance in bp between the first mates of a junction and a centroid
+     * \param[in] clustering_cutoff - distance cutoff for merging a junction into a centroid
+     */
+    SelfBalancingBinaryTreeClusterer(int32_t const partition_max_distance, double const clustering_cutoff) :
+        partition_max_distance{partition_max_distance},
+        clustering_cutoff{clustering_cutoff}
+    {}
+    //!\}
+
+    //! \brief Merges a junction into the nearest centroid or adds it as a new centroid.
+    void insert(Junction && junction);
+
+    //! \brief Returns the number of clusters.
+    size_t size() const noexcept
+    {
+        return centroids.size();
+    }
+
+    /*! \brief Returns the clusters and empties the clusterer.
+     *
+     * \returns Returns sorted clusters of sorted junctions.
+     */
+    std::vector<Cluster> extract_clusters();
+};
+
+/*! \brief Cluster junctions by inserting them into a SelfBalancingBinaryTreeClusterer.
+ *         The returned clusters and the junctions in each returned cluster are sorted.
+ *
+ * \param[in] junctions - a vector of junctions (needs to be sorted), moved into the clusters
+ * \param[in] partition_max_distance - maximum distance in bp between the first mates of a junction and a centroid
+ * \param[in] clustering_cutoff - distance cutoff for merging a junction into a centroid
+ *
+ * \returns Returns sorted clusters of sorted junctions.
+ */
+std::vector<Cluster> self_balancing_binary_tree_method(std::vector<Junction> junctions,
+                                                       int32_t const partition_max_distance,
+                                                       double const clustering_cutoff);
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "structures/junction.hpp"  // for class Junction
+#include "structures/junction.hpp"          // for class Junction
+#include "structures/query_sequence.hpp"    // for query_sequence_t
 
 /*! \brief This function steps through the CIGAR string and stores junctions with their position in reference and read.
  *
@@ -8,7 +9,7 @@
  * \param[in]       chromosome      - RNAME field of the SAM/BAM file
  * \param[in]       query_start_pos - POS field of the SAM/BAM file
  * \param[in]       cigar_string    - CIGAR field of the SAM/BAM file
- * \param[in]       query_sequence  - SEQ field of the SAM/BAM file
+ * \param[in]       query_sequence  - SEQ field of the SAM/BAM file (a query_sequence_t or a seqan3::dna5_vector)
  * \param[in, out]  junctions       - vector for storing junctions
  * \param[in]       min_length      - minimum length of variants to detect (default 30 bp, expected to be non-negative)
  *
@@ -27,13 +28,15 @@
  *          Other CIGAR operations: H, N, P are skipped (H: hard clipping sequences are not present in the SEQ, N:
  *          skipped region representing an intron, P: padding consumes neither the query nor the reference).
  *          The junctions found are stored in the given `junctions` vector.
+ *          Only the inserted bases of the stored junctions are converted from the query sequence.
  *          For more information about CIGAR operations see the
  *          [Map Format Specification](https://samtools.github.io/hts-specs/SAMv1.pdf#page=8) (last access 09.04.2021).
  */
+template <typename sequence_t>
 void analyze_cigar(std::string const & read_name,
                    std::string const & chromosome,
                    int32_t const query_start_pos,
-                   std::vector<seqan3::cigar> & cigar_string,
-                   seqan3::dna5_vector const & query_sequence,
+                   std::vector<seqan3::cigar> const & cigar_string,
+                   sequence_t const & query_sequence,
                    std::vector<Junction> & junctions,
                    int32_t const min_length);
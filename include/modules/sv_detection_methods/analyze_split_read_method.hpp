@@ -1,8 +1,11 @@
 #pragma once
 
+#include <string_view>   // for std::string_view
+
 #include "iGenVar.hpp"                          // for struct cmd_arguments
 #include "structures/aligned_segment.hpp"       // for struct AlignedSegment
 #include "structures/junction.hpp"              // for class Junction
+#include "structures/query_sequence.hpp"        // for query_sequence_t
 #include "variant_detection/bam_functions.hpp"  // for seqan3::sam_flag and hasFlag* functions
 
 /*! \brief Splits a string by a given delimiter and stores substrings in a given container.
@@ -28,13 +31,13 @@ void split_string(std::string const & str, Container & cont, char const delim =
  *          Each element (in parentheses) represents one alignment segment of the chimeric alignment formatted as
  *          a colon-delimited list.
  *          We add all segments to our candidate list `aligned_segments` and examine them in the following function
- *          `analyze_aligned_segments()`.
+ *          `analyze_aligned_segments()`. Malformed segments are reported and skipped.
  *
  *          For more information about this tag, see the
  *          [Map Optional Fields Specification](https://samtools.github.io/hts-specs/SAMtags.pdf)
  *          (last access 09.04.2021).
  */
-void retrieve_aligned_segments(std::string const & sa_string, std::vector<AlignedSegment> & aligned_segments);
+void retrieve_aligned_segments(std::string_view const sa_string, std::vector<AlignedSegment> & aligned_segments);
 
 /*! \brief Calculates the end respectively start position of two consecutive mates (current and next
  *         [AlignedSegment](\ref AlignedSegment)) depending on their orientation and corrects the position of the second
@@ -60,20 +63,24 @@ void retrieve_aligned_segments(std::string const & sa_string, std::vector<Aligne
                          mate1_pos mate2_pos
     \endverbatim
  */
-std::pair<int32_t, int32_t> get_mate_positions(AlignedSegment current, AlignedSegment next, int32_t distance_on_read);
+std::pair<int32_t, int32_t> get_mate_positions(AlignedSegment const & current,
+                                               AlignedSegment const & next,
+                                               int32_t const distance_on_read);
 
 /*! \brief Build junctions out of aligned_segments.
  *
  * \param[in]       aligned_segments    - vector of [aligned_segments](\ref AlignedSegment)
  * \param[in, out]  junctions           - vector for storing junctions
- * \param[in, out]  query_sequence      - SEQ field of the SAM/BAM file
+ * \param[in]       query_sequence      - SEQ field of the SAM/BAM file (a query_sequence_t or a seqan3::dna5_vector),
+ *                                        only the inserted and inverted bases of the stored junctions are converted
  * \param[in]       read_name           - QNAME field of the SAM/BAM file
  * \param[in]       min_length          - minimum length of variants to detect (expected to be non-negative)
  * \param[in]       max_overlap         - maximum overlap between alignment segments (expected to be non-negative)
  */
+template <typename sequence_t>
 void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segments,
                               std::vector<Junction> & junctions,
-                              seqan3::dna5_vector const & query_sequence,
+                              sequence_t const & query_sequence,
                               std::string const & read_name,
                               int32_t const min_length,
                               int32_t const max_overlap);
@@ -88,20 +95,21 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
  * \param[in]       pos         - POS field of the SAM/BAM file
  * \param[in]       mapq        - MAPQ field of the SAM/BAM file
  * \param[in]       cigar       - CIGAR field of the SAM/BAM file
- * \param[in]       seq         - SEQ field of the SAM/BAM file
+ * \param[in]       seq         - SEQ field of the SAM/BAM file (a query_sequence_t or a seqan3::dna5_vector)
  * \param[in]       sa_tag      - SA tag, one tag from the read of the SAM/BAM file
  * \param[in]       args        - command line arguments:\n
  *                                **args.min_var_length** - minimum length of variants to detect (expected to be non-negative)\n
  *                                **args.max_overlap** - maximum overlap between alignment segments (expected to be non-negative)
  * \param[in, out]  junctions   - vector for storing junctions
  */
+template <typename sequence_t>
 void analyze_sa_tag(std::string const & query_name,
                     seqan3::sam_flag const & flag,
                     std::string const & ref_name,
                     int32_t const pos,
                     uint8_t const mapq,
                     std::vector<seqan3::cigar> const & cigar,
-                    seqan3::dna5_vector const & seq,
+                    sequence_t const & seq,
                     std::string const & sa_tag,
                     cmd_arguments const & args,
                     std::vector<Junction> & junctions);
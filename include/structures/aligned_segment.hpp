@@ -12,30 +12,73 @@
  * \param pos           - start position of the alignment
  * \param mapq          - mapping quality
  * \param cig           - cigar string of the alignment
+ *
+ * \details The reference end, the soft clips and the query length are computed in a single pass over the CIGAR string
+ *          on construction, because they are queried repeatedly while sorting and analysing the segments of a read.
+ *          Thus, `pos` and `cig` are private and can only be read by get_reference_start() and get_cigar().
  */
 struct AlignedSegment
 {
     strand orientation;
     std::string ref_name;
-    int32_t pos;
     int32_t mapq;
-    std::vector<seqan3::cigar> cig;
+
+    AlignedSegment(strand the_orientation,
+                   std::string the_ref_name,
+                   int32_t the_pos,
+                   int32_t the_mapq,
+                   std::vector<seqan3::cigar> the_cig);
 
     //! \brief Returns the reference position of the first aligned based.
-    int32_t get_reference_start() const;
+    int32_t get_reference_start() const
+    {
+        return pos;
+    }
 
     //! \brief Returns the reference position of the last aligned based.
-    int32_t get_reference_end() const;
+    int32_t get_reference_end() const
+    {
+        return reference_end;
+    }
 
-    int32_t get_left_soft_clip() const;
+    //! \brief Returns the cigar string of the alignment.
+    std::vector<seqan3::cigar> const & get_cigar() const
+    {
+        return cig;
+    }
 
-    int32_t get_right_soft_clip() const;
+    int32_t get_left_soft_clip() const
+    {
+        return left_soft_clip;
+    }
 
-    int32_t get_query_start() const;
+    int32_t get_right_soft_clip() const
+    {
+        return right_soft_clip;
+    }
 
-    int32_t get_query_length() const;
+    int32_t get_query_start() const
+    {
+        return (orientation == strand::forward) ? left_soft_clip : right_soft_clip;
+    }
 
-    int32_t get_query_end() const;
+    int32_t get_query_length() const
+    {
+        return query_length;
+    }
+
+    int32_t get_query_end() const
+    {
+        return query_length - ((orientation == strand::forward) ? right_soft_clip : left_soft_clip);
+    }
+
+private:
+    int32_t pos;
+    std::vector<seqan3::cigar> cig;
+    int32_t reference_end{};
+    int32_t left_soft_clip{};
+    int32_t right_soft_clip{};
+    int32_t query_length{};
 };
 
 template <typename stream_t>
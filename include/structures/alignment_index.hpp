@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>      // for int32_t, int64_t and uint64_t
+#include <filesystem>   // for std::filesystem::path
+#include <ios>          // for std::streamoff
+#include <span>         // for std::span
+#include <vector>
+
+/*! \brief A linear index of a coordinate sorted alignment file, which is memory-mapped and queried in place.
+ *
+ * \details Like the linear index of BAI, each reference sequence is divided into windows of `window_size` bases and
+ *          the index stores for each window the smallest file position of the records overlapping it, or -1 if no
+ *          record overlaps it. The index file consists of a header (magic number, format version, number of
+ *          reference sequences and a checksum), a table with the first window and the number of windows of each
+ *          reference sequence and the file positions of the windows of all reference sequences in the order of the
+ *          alignment file. It contains no pointers, thus opening it does not parse or allocate anything and
+ *          concurrent processes share the pages of the file. The checksum covers the whole file, the size of the file
+ *          must match the number of windows. All values are stored in the native byte order.
+ */
+class AlignmentIndex
+{
+private:
+    void * mapping{nullptr};
+    size_t mapping_size{0};
+    uint32_t amount_references{0};
+    uint64_t const * reference_table{nullptr};
+    int64_t const * all_windows{nullptr};
+
+public:
+    //! \brief The version of the file format, which is increased on every change of the format.
+    static constexpr uint32_t format_version = 2;
+    //! \brief The number of bases of a window, 16 kb as in BAI.
+    static constexpr int32_t window_size = 16384;
+
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    AlignmentIndex()                                    = default; //!< Defaulted.
+    AlignmentIndex(AlignmentIndex const &)              = delete;  //!< Deleted, the mapping is owned.
+    AlignmentIndex(AlignmentIndex && other) noexcept;
+    AlignmentIndex & operator=(AlignmentIndex const &)  = delete;  //!< Deleted, the mapping is owned.
+    AlignmentIndex & operator=(AlignmentIndex && other) noexcept;
+    ~AlignmentIndex();
+
+    /*! \brief Memory-maps an index file.
+     *
+     * \param[in] index_file_path - path to the index file
+     *
+     * \throws std::runtime_error if the file cannot be mapped or is not a valid index of this format version.
+     */
+    explicit AlignmentIndex(std::filesystem::path const & index_file_path);
+    //!\}
+
+    //! \brief Returns the number of reference sequences.
+    size_t size() const noexcept
+    {
+        return amount_references;
+    }
+
+    //! \brief Returns the smallest file positions of the records overlapping the windows of a reference sequence.
+    std::span<int64_t const> windows(int32_t const ref_id) const noexcept;
+
+    /*! \brief Finds a file position in front of all alignment records, which overlap a region.
+     *
+     * \param[in] ref_id    - the index of the reference sequence
+     * \param[in] start     - 0-based start position of the region
+     * \param[in] end       - 0-based end position of the region (exclusive)
+     *
+     * \returns The file position of the first record overlapping the first window of the region, which is overlapped
+     *          by any record, or -1 if no record overlaps a window of the region. The records in front of the
+     *          region have to be skipped by the caller.
+     */
+    std::streamoff first_overlap(int32_t const ref_id, int32_t const start, int32_t const end) const noexcept;
+};
+
+/*! \brief Collects the windows of an alignment index from the records of a coordinate sorted alignment file and writes
+ *         them in the format of AlignmentIndex.
+ */
+class AlignmentIndexBuilder
+{
+private:
+    std::vector<std::vector<int64_t>> windows_per_reference;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    AlignmentIndexBuilder()                                          = default; //!< Defaulted.
+    AlignmentIndexBuilder(AlignmentIndexBuilder const &)             = default; //!< Defaulted.
+    AlignmentIndexBuilder(AlignmentIndexBuilder &&)                  = default; //!< Defaulted.
+    AlignmentIndexBuilder & operator=(AlignmentIndexBuilder const &) = default; //!< Defaulted.
+    AlignmentIndexBuilder & operator=(AlignmentIndexBuilder &&)      = default; //!< Defaulted.
+    ~AlignmentIndexBuilder()                                         = default; //!< Defaulted.
+
+    /*! \brief Construct a builder for an alignment file.
+     * \param amount_references - the number of reference sequences in the header of the alignment file
+     */
+    explicit AlignmentIndexBuilder(size_t const amount_references) : windows_per_reference(amount_references)
+    {}
+    //!\}
+
+    /*! \brief Adds an alignment record. The records have to be added in the order of the file.
+     *
+     * \param[in] ref_id        - the index of the reference sequence
+     * \param[in] start         - 0-based start position of the alignment
+     * \param[in] end           - 0-based end position of the alignment (exclusive)
+     * \param[in] file_position - position of the alignment record in the alignment file
+     */
+    void add(int32_t const ref_id, int32_t const start, int32_t const end, std::streamoff const file_position);
+
+    /*! \brief Writes the index file.
+     *
+     * \param[in] index_file_path - path to the index file
+     *
+     * \throws std::runtime_error if the file cannot be written.
+     */
+    void write(std::filesystem::path const & index_file_path) const;
+};
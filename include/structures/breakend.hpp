@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "structures/interned_string.hpp"  // for class InternedString
+
 enum struct strand : uint8_t
 {
     forward,
@@ -10,7 +12,7 @@ enum struct strand : uint8_t
 
 struct Breakend
 {
-    std::string seq_name; // The id of the respective sequence
+    InternedString seq_name; // The id of the respective sequence
     int32_t position;
     strand orientation;
 
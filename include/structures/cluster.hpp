@@ -4,10 +4,23 @@
 
 #include "structures/junction.hpp"  // for class Junction
 
+/*! \brief A cluster of junctions, which are supposed to support the same variant.
+ *
+ * \details The summary statistics of the members (average mates, common tandem duplication count and average inserted
+ *          sequence size) are computed once, when the cluster is constructed, because they are queried repeatedly
+ *          while sorting and writing the clusters. The members cannot be changed after construction.
+ */
 class Cluster
 {
 private:
     std::vector<Junction> members{};
+    Breakend average_mate1{};
+    Breakend average_mate2{};
+    size_t common_tandem_dup_count{0};
+    size_t average_inserted_sequence_size{0};
+
+    //! \brief Computes the summary statistics of the members.
+    void compute_statistics();
 
 public:
     /*!\name Constructors, destructor and assignment
@@ -20,9 +33,14 @@ public:
     Cluster & operator=(Cluster &&)        = default; //!< Defaulted.
     ~Cluster()                             = default; //!< Defaulted.
 
+    /*! \brief Construct a cluster from its members.
+     *
+     * \throws std::runtime_error if the first or second mates of the members have different sequence names or
+     *         orientations.
+     */
     Cluster(std::vector<Junction> members) : members{std::move(members)}
     {
-
+        compute_statistics();
     }
     //!\}
 
@@ -33,13 +51,13 @@ public:
     *          All cluster members are required to have identical sequence names and orientations for their first mate.
     *          To produce the average, the average first mate's position of all cluster members is computed.
     */
-    Breakend get_average_mate1() const;
+    Breakend const & get_average_mate1() const;
 
     /*! \brief Returns the average second mate of all cluster members.
     *          All cluster members are required to have identical sequence names and orientations for their second mate.
     *          To produce the average, the average second mate's position of all cluster members is computed.
     */
-    Breakend get_average_mate2() const;
+    Breakend const & get_average_mate2() const;
 
     //! \brief Returns either the average tandem_dup_count of the inserted tandem duplications of all cluster members
     //         with tandem_dup_count != 0, or 0 if most (2/3) of the members have a tandem_dup_count = 0.
@@ -49,7 +67,7 @@ public:
     size_t get_average_inserted_sequence_size() const;
 
     //! \brief Returns the members of the cluster.
-    std::vector<Junction> get_members() const;
+    std::vector<Junction> const & get_members() const;
 };
 
 template <typename stream_t>
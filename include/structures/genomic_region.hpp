@@ -0,0 +1,62 @@
+#pragma once
+
+#include <filesystem>   // for std::filesystem::path
+#include <limits>       // for std::numeric_limits
+#include <string>
+#include <vector>
+
+/*! \brief An interval on a reference sequence, to which the detection of junctions can be restricted.
+ *
+ * \param seq_name  - reference/chromosome name (with "chr" prefix like the reference names of the alignment files)
+ * \param start     - 0-based position of the first base of the region
+ * \param end       - 0-based position behind the last base of the region
+ */
+struct GenomicRegion
+{
+    std::string seq_name;
+    int32_t start{0};
+    int32_t end{std::numeric_limits<int32_t>::max()};
+};
+
+/*! \brief Parses a region given in the samtools notation `chr:start-end`, `chr:start` or `chr`, with 1-based inclusive
+ *         coordinates. Thousands separators (',') are allowed in the coordinates.
+ *
+ * \param[in] region_string - the region
+ *
+ * \returns The parsed region.
+ * \throws std::invalid_argument if the region is malformed.
+ */
+GenomicRegion parse_region(std::string const & region_string);
+
+/*! \brief Reads the regions of a BED file. Only the first three columns (chrom, chromStart, chromEnd) are used, which
+ *         are 0-based and half-open. Empty lines and header lines (`#`, `track`, `browser`) are skipped.
+ *
+ * \param[in] bed_file_path - path to the BED file
+ *
+ * \returns The regions in the order of the file.
+ * \throws std::invalid_argument if a line is malformed or std::runtime_error if the file cannot be opened.
+ */
+std::vector<GenomicRegion> read_regions_bed(std::filesystem::path const & bed_file_path);
+
+/*! \brief A region is smaller than another, if its reference name, start or end (in this order) is smaller than the
+ *         corresponding element of the other region.
+ *
+ * \param lhs - left side region
+ * \param rhs - right side region
+ */
+bool operator<(GenomicRegion const & lhs, GenomicRegion const & rhs);
+
+/*! \brief A region is equal to another, if all their members are equal.
+ *
+ * \param lhs - left side region
+ * \param rhs - right side region
+ */
+bool operator==(GenomicRegion const & lhs, GenomicRegion const & rhs);
+
+template <typename stream_t>
+inline constexpr stream_t operator<<(stream_t && stream, GenomicRegion const & region)
+{
+    // Print 1-based inclusive coordinates like they are given on the command line.
+    stream << region.seq_name << ":" << (int64_t{region.start} + 1) << "-" << region.end;
+    return stream;
+}
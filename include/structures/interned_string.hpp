@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+
+/*! \brief A string that is stored only once in a global pool. A copy of an interned string is a pointer into the
+ *         pool, thus copies are cheap and equal strings are compared by their address.
+ *
+ * \details Junctions repeat the same reference sequence names millions of times, which are interned to save memory
+ *          and to speed up sorting. The pool is never cleared, thus only strings of a bounded set like the reference
+ *          sequence names are interned and not the read names, whose number grows with the input. Interning is
+ *          thread-safe.
+ */
+class InternedString
+{
+private:
+    //! \brief The empty string, which is not part of the pool.
+    inline static std::string const empty_string{};
+
+    std::string const * str{&empty_string};
+
+    //! \brief Returns the address of the pooled copy of `value`, which is added to the pool if it is missing.
+    static std::string const * intern(std::string const & value);
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    constexpr InternedString() noexcept                          = default; //!< Defaulted.
+    InternedString(InternedString const &) noexcept              = default; //!< Defaulted.
+    InternedString(InternedString &&) noexcept                   = default; //!< Defaulted.
+    InternedString & operator=(InternedString const &) noexcept  = default; //!< Defaulted.
+    InternedString & operator=(InternedString &&) noexcept       = default; //!< Defaulted.
+    ~InternedString()                                            = default; //!< Defaulted.
+
+    InternedString(std::string const & value) : str{intern(value)}
+    {}
+
+    InternedString(char const * value) : str{intern(value)}
+    {}
+    //!\}
+
+    //! \brief Returns the pooled string.
+    std::string const & get() const noexcept
+    {
+        return *str;
+    }
+
+    //! \brief Interned strings can be used wherever a std::string is read.
+    operator std::string const &() const noexcept
+    {
+        return *str;
+    }
+
+    /*! \brief Two interned strings are equal, if they point to the same pooled string. A std::string or a string
+     *         literal is interned for the comparison.
+     */
+    friend bool operator==(InternedString const & lhs, InternedString const & rhs) noexcept
+    {
+        return lhs.str == rhs.str;
+    }
+
+    //! \brief Interned strings are ordered lexicographically like std::string.
+    friend bool operator<(InternedString const & lhs, InternedString const & rhs) noexcept
+    {
+        return lhs.str != rhs.str && *lhs.str < *rhs.str;
+    }
+
+    /*! \brief Writes the pooled string to a stream. It is found only by argument-dependent lookup, otherwise the
+     *         implicit conversion from string literals would make writing string literals to a stream ambiguous.
+     */
+    template <typename stream_t>
+    friend constexpr stream_t operator<<(stream_t && stream, InternedString const & s)
+    {
+        stream << s.get();
+        return stream;
+    }
+};
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>   // for std::make_shared and std::shared_ptr
+#include <string>   // for std::string
+
+#include <seqan3/alphabet/container/bitpacked_sequence.hpp>
 #include <seqan3/alphabet/nucleotide/dna5.hpp>
 #include <seqan3/alphabet/views/char_to.hpp>
 #include <seqan3/alphabet/views/complement.hpp>
@@ -12,29 +16,34 @@ class Junction
 private:
     Breakend mate1{};
     Breakend mate2{};
-    seqan3::dna5_vector inserted_sequence{};
+    seqan3::bitpacked_sequence<seqan3::dna5> inserted_sequence{};
     size_t tandem_dup_count{};
-    std::string read_name{};
+    std::shared_ptr<std::string const> read_name{};
 
 public:
     /*!\name Constructors, destructor and assignment
      * \{
      */
-    constexpr Junction()                    = default; //!< Defaulted.
+    Junction()                              = default; //!< Defaulted.
     Junction(Junction const &)              = default; //!< Defaulted.
     Junction(Junction &&)                   = default; //!< Defaulted.
     Junction & operator=(Junction const &)  = default; //!< Defaulted.
     Junction & operator=(Junction &&)       = default; //!< Defaulted.
     ~Junction()                             = default; //!< Defaulted.
 
+    /*! \brief Construct a junction, which shares the read name with the other junctions of the same read.
+     *
+     * \details The read names are not interned, because their number grows with the input. A shared read name is
+     *          freed with the last junction of the read.
+     */
     Junction(Breakend the_mate1,
              Breakend the_mate2,
              auto const & the_inserted_sequence,
              size_t the_tandem_dup_count,
-             std::string the_read_name) : mate1{std::move(the_mate1)},
-                                          mate2{std::move(the_mate2)},
-                                          tandem_dup_count{the_tandem_dup_count},
-                                          read_name{std::move(the_read_name)}
+             std::shared_ptr<std::string const> the_read_name) : mate1{std::move(the_mate1)},
+                                                                 mate2{std::move(the_mate2)},
+                                                                 tandem_dup_count{the_tandem_dup_count},
+                                                                 read_name{std::move(the_read_name)}
     {
         if ((mate2.seq_name < mate1.seq_name) ||
             (mate2.seq_name == mate1.seq_name && mate2.position < mate1.position))
@@ -43,31 +52,46 @@ public:
             mate1.flip_orientation();
             mate2.flip_orientation();
 
-            inserted_sequence = the_inserted_sequence | std::views::reverse | seqan3::views::complement | seqan3::ranges::to<seqan3::dna5_vector>();
+            inserted_sequence = seqan3::bitpacked_sequence<seqan3::dna5>(the_inserted_sequence
+                                                                         | std::views::reverse
+                                                                         | seqan3::views::complement);
         }
         else
         {
-            inserted_sequence = the_inserted_sequence | seqan3::ranges::to<seqan3::dna5_vector>();
+            inserted_sequence = seqan3::bitpacked_sequence<seqan3::dna5>(the_inserted_sequence);
         }
     }
+
+    //! \brief Construct a junction with its own copy of the read name.
+    Junction(Breakend the_mate1,
+             Breakend the_mate2,
+             auto const & the_inserted_sequence,
+             size_t the_tandem_dup_count,
+             std::string const & the_read_name) : Junction{std::move(the_mate1),
+                                                           std::move(the_mate2),
+                                                           the_inserted_sequence,
+                                                           the_tandem_dup_count,
+                                                           std::make_shared<std::string const>(the_read_name)}
+    {}
     //!\}
 
     //! \brief Returns the first mate of this junction.
-    Breakend get_mate1() const;
+    Breakend const & get_mate1() const;
 
     //! \brief Returns the second mate of this junction.
-    Breakend get_mate2() const;
+    Breakend const & get_mate2() const;
 
     /*! \brief Returns the sequence inserted between the two mates.
     *          If the two mates are connected directly, the inserted sequence is empty.
+    *          The sequence is stored bit-packed (3 bits per base).
     */
-    seqan3::dna5_vector get_inserted_sequence() const;
+    seqan3::bitpacked_sequence<seqan3::dna5> const & get_inserted_sequence() const;
 
     //! \brief Returns the number of tandem copies of this junction.
     size_t get_tandem_dup_count() const;
 
     //! \brief Returns the name of the read giving rise to this junction.
-    std::string get_read_name() const;
+    std::string const & get_read_name() const;
 };
 
 template <typename stream_t>
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstdint>          // for uint32_t and uint64_t
+#include <filesystem>       // for std::filesystem::path
+#include <fstream>          // for std::ofstream
+#include <functional>       // for std::function
+#include <map>              // for std::map
+#include <memory>           // for std::shared_ptr and std::unique_ptr
+#include <string>
+#include <unordered_map>    // for std::unordered_map
+#include <vector>
+
+#include "structures/cluster.hpp"           // for class Cluster
+#include "structures/interned_string.hpp"   // for class InternedString
+#include "structures/junction.hpp"          // for class Junction
+
+//! \brief The content of a junction dump: the junctions of the junction output or the clusters of the cluster output.
+enum struct dump_content : uint32_t
+{
+    junctions,
+    clusters
+};
+
+/*! \brief A binary dump of junctions or clusters (.igvd), which is memory-mapped and read without parsing text.
+ *
+ * \details The dump file consists of a header (magic number, format version, content and the amounts of references,
+ *          strings, junctions and clusters), the junction records of fixed size, for a cluster dump the index of the
+ *          first junction of each cluster, the names and lengths of the reference sequences, the string table of the
+ *          sequence and read names and the inserted sequences with three bases per byte. The junction records refer to
+ *          the strings and the inserted sequences by their index and offset, thus the dump contains no pointers and
+ *          each junction can be read in place. The reference sequences are stored, such that the VCF header can be
+ *          written without the alignment file. All values are stored in the native byte order.
+ */
+class JunctionDump
+{
+private:
+    void * mapping{nullptr};
+    size_t mapping_size{0};
+    dump_content content{dump_content::junctions};
+    uint64_t amount_junctions{0};
+    uint64_t amount_clusters{0};
+    uint32_t amount_references{0};
+    size_t references_offset{0};
+    size_t sequences_offset{0};
+    std::vector<std::shared_ptr<std::string const>> strings{};
+
+public:
+    //! \brief The version of the file format, which is increased on every change of the format.
+    static constexpr uint32_t format_version = 1;
+
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    JunctionDump()                                  = default; //!< Defaulted.
+    JunctionDump(JunctionDump const &)              = delete;  //!< Deleted, the mapping is owned.
+    JunctionDump(JunctionDump && other) noexcept;
+    JunctionDump & operator=(JunctionDump const &)  = delete;  //!< Deleted, the mapping is owned.
+    JunctionDump & operator=(JunctionDump && other) noexcept;
+    ~JunctionDump();
+
+    /*! \brief Memory-maps a dump file and reads its strings, which are shared by the junctions read from the dump.
+     *
+     * \param[in] dump_file_path - path to the dump file
+     *
+     * \throws std::runtime_error if the file cannot be mapped or is not a valid dump of this format version.
+     */
+    explicit JunctionDump(std::filesystem::path const & dump_file_path);
+    //!\}
+
+    //! \brief Returns whether the dump contains junctions or clusters.
+    dump_content get_content() const noexcept
+    {
+        return content;
+    }
+
+    //! \brief Returns the number of junctions, for a cluster dump the number of all cluster members.
+    size_t size() const noexcept
+    {
+        return amount_junctions;
+    }
+
+    /*! \brief Returns a junction of the dump.
+     *
+     * \param[in] index - the index of the junction, which has to be smaller than size()
+     *
+     * \throws std::runtime_error if the junction refers to a string or sequence outside of the dump.
+     */
+    Junction junction(size_t const index) const;
+
+    //! \brief Returns all junctions of the dump in their stored order, for a cluster dump cluster by cluster.
+    std::vector<Junction> junctions() const;
+
+    //! \brief Returns the clusters of a cluster dump, for a junction dump an empty vector.
+    std::vector<Cluster> clusters() const;
+
+    //! \brief Returns the reference sequence dictionary of the alignment file, in which the junctions were detected.
+    std::map<std::string, int32_t> references_lengths() const;
+};
+
+/*! \brief Writes junctions or clusters in the format of JunctionDump.
+ *
+ * \details The junction records are written when they are added, the tables are kept in memory and written by close(),
+ *          which writes the header last. The junctions of a cluster are written in the order of its members.
+ */
+class JunctionDumpWriter
+{
+private:
+    std::ofstream file{};
+    std::filesystem::path dump_file_path{};
+    dump_content content{dump_content::junctions};
+    bool closed{false};
+    uint64_t amount_junctions{0};
+    std::vector<uint64_t> cluster_offsets{};
+    std::vector<std::pair<uint32_t, int32_t>> references{};
+    std::unordered_map<std::string const *, uint32_t> string_ids{};
+    std::unordered_map<std::string, uint32_t> read_name_ids{};
+    std::vector<std::string const *> strings{};
+    std::string sequences{};
+
+    //! \brief Returns the index of an interned string in the string table, which is added if it is missing.
+    uint32_t get_string_id(InternedString const & value);
+
+    /*! \brief Returns the index of a read name in the string table, which is added if it is missing. The read names
+     *         are not interned, thus they are looked up by their value and copied into the writer.
+     */
+    uint32_t get_read_name_id(std::string const & read_name);
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    JunctionDumpWriter(JunctionDumpWriter const &)             = delete;  //!< Deleted, the file is owned.
+    JunctionDumpWriter(JunctionDumpWriter &&)                  = delete;  //!< Deleted, the file is owned.
+    JunctionDumpWriter & operator=(JunctionDumpWriter const &) = delete;  //!< Deleted, the file is owned.
+    JunctionDumpWriter & operator=(JunctionDumpWriter &&)      = delete;  //!< Deleted, the file is owned.
+    ~JunctionDumpWriter();                                                //!< Closes the file, errors are ignored.
+
+    /*! \brief Opens a dump file.
+     *
+     * \param[in] dump_file_path     - path to the dump file
+     * \param[in] references_lengths - reference sequence dictionary parsed from \@SQ header lines
+     * \param[in] content            - whether junctions or clusters are added
+     *
+     * \throws std::runtime_error if the file cannot be opened.
+     */
+    JunctionDumpWriter(std::filesystem::path const & dump_file_path,
+                       std::map<std::string, int32_t> const & references_lengths,
+                       dump_content const content);
+    //!\}
+
+    //! \brief Adds a junction to a junction dump.
+    void add(Junction const & junction);
+
+    //! \brief Adds a cluster to a cluster dump.
+    void add(Cluster const & cluster);
+
+    /*! \brief Writes the tables and the header and closes the file.
+     *
+     * \throws std::runtime_error if the file cannot be written.
+     */
+    void close();
+};
+
+/*! \brief Sorts junctions, which do not fit into memory, by spilling sorted runs to a temporary JunctionDump.
+ *
+ * \details The added junctions are buffered until `junctions_per_run` junctions are reached. The buffer is then sorted
+ *          and spilled as a run to a temporary dump file, which is created with a unique name in the temporary
+ *          directory on the first spill and removed by the destructor. merge() merges the runs and the remaining buffer
+ *          by a k-way merge, thus the junctions are handed over in the order of `std::sort` no matter in which order
+ *          they were added, e.g. the junctions of split reads found on another reference sequence.
+ */
+class JunctionSorter
+{
+private:
+    std::map<std::string, int32_t> references_lengths{};
+    size_t junctions_per_run{0};
+    std::vector<Junction> buffer{};
+    std::filesystem::path spill_file_path{};
+    std::unique_ptr<JunctionDumpWriter> spill{};
+    std::vector<size_t> run_ends{};
+
+    //! \brief Sorts the buffer and appends it to the dump as a run.
+    void spill_buffer();
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    JunctionSorter(JunctionSorter const &)             = delete;  //!< Deleted, the spill file is owned.
+    JunctionSorter(JunctionSorter &&)                  = delete;  //!< Deleted, the spill file is owned.
+    JunctionSorter & operator=(JunctionSorter const &) = delete;  //!< Deleted, the spill file is owned.
+    JunctionSorter & operator=(JunctionSorter &&)      = delete;  //!< Deleted, the spill file is owned.
+    ~JunctionSorter();                                            //!< Removes the spill file, errors are ignored.
+
+    /*! \brief Construct an empty sorter.
+     *
+     * \param[in] references_lengths - reference sequence dictionary parsed from \@SQ header lines
+     * \param[in] junctions_per_run  - the number of junctions, which are kept in memory and sorted at once
+     */
+    JunctionSorter(std::map<std::string, int32_t> const & references_lengths, size_t const junctions_per_run);
+    //!\}
+
+    /*! \brief Adds a junction in any order.
+     *
+     * \throws std::runtime_error if the spill file cannot be created or written.
+     */
+    void add(Junction && junction);
+
+    /*! \brief Hands over all added junctions sorted in batches of whole partitions.
+     *
+     * \param[in] partition_max_distance - maximum distance between junctions in the same partition
+     * \param[in] junctions_per_batch    - the minimum size of a batch, only the last batch may be smaller
+     * \param[in] process_batch          - called with each batch of sorted junctions
+     *
+     * \details A batch is only handed over in front of a junction on another reference sequence, in another orientation
+     *          or more than `partition_max_distance` behind the last junction of the batch, i.e. at a border of the
+     *          partitions of partition_junctions(). The sorter is empty afterwards.
+     *
+     * \throws std::runtime_error if the spill file cannot be written or read.
+     */
+    void merge(int32_t const partition_max_distance,
+               size_t const junctions_per_batch,
+               std::function<void(std::vector<Junction> &)> const & process_batch);
+};
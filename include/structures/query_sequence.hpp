@@ -0,0 +1,41 @@
+#pragma once
+
+#include <seqan3/alphabet/container/bitpacked_sequence.hpp>
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+#include <seqan3/alphabet/nucleotide/dna16sam.hpp>
+#include <seqan3/alphabet/views/char_to.hpp>
+#include <seqan3/alphabet/views/to_char.hpp>
+#include <seqan3/io/sam_file/input_options.hpp>
+#include <seqan3/utility/views/slice.hpp>
+
+/*! \brief The SEQ field of an alignment as it is read from the SAM/BAM file.
+ *
+ * \details The bases are kept in seqan3::dna16sam, the 4-bit alphabet of the BAM format, and are stored bit-packed.
+ *          Reading a BAM record thus only copies the nibbles and a read of 20 kb occupies 10 kB. The bases are
+ *          converted to seqan3::dna5 only for the slices that end up in a junction, see query_slice().
+ */
+using query_sequence_t = seqan3::bitpacked_sequence<seqan3::dna16sam>;
+
+//! \brief Traits of the alignment input files, such that the SEQ field is read into a query_sequence_t.
+struct alignment_file_traits : seqan3::sam_file_input_default_traits<>
+{
+    using sequence_alphabet = seqan3::dna16sam;
+
+    template <typename alphabet_type>
+    using sequence_container = seqan3::bitpacked_sequence<alphabet_type>;
+};
+
+/*! \brief Returns a view on a part of a query sequence, which is decoded to seqan3::dna5 on access.
+ *
+ * \param[in] query_sequence - the SEQ field of an alignment (a query_sequence_t or a seqan3::dna5_vector)
+ * \param[in] begin          - the position of the first base of the slice
+ * \param[in] end            - the position behind the last base of the slice
+ *
+ * \details Ambiguous bases and '=' are converted to 'N'.
+ */
+inline auto query_slice(auto const & query_sequence, size_t const begin, size_t const end)
+{
+    return query_sequence | seqan3::views::slice(begin, end)
+                          | seqan3::views::to_char
+                          | seqan3::views::char_to<seqan3::dna5>;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>            // for std::array
+#include <cstdint>          // for int64_t and uint64_t
+#include <filesystem>       // for std::filesystem::path
+#include <string>
+#include <unordered_map>    // for std::unordered_map
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>  // for seqan3::dna5_vector
+
+#include "structures/interned_string.hpp"       // for class InternedString
+
+/*! \brief An entry of a FASTA index (.fai), which locates the bases of a reference sequence in the FASTA file.
+ *
+ * \param length     - the number of bases of the reference sequence
+ * \param offset     - position of the first base in the FASTA file
+ * \param line_bases - the number of bases per line
+ * \param line_width - the number of bytes per line, including the line break
+ */
+struct FastaIndexEntry
+{
+    uint64_t length;
+    uint64_t offset;
+    uint64_t line_bases;
+    uint64_t line_width;
+};
+
+/*! \brief A reference genome in FASTA format, which is memory-mapped and read by random access.
+ *
+ * \details The bases are located by the FASTA index "<fasta_file_path>.fai", which is created by `samtools faidx`.
+ *          If there is no index, it is built by scanning the FASTA file once. The bases are not copied, thus opening
+ *          the genome takes no memory for the sequences and concurrent threads share the pages of the file.
+ */
+class ReferenceGenome
+{
+private:
+    void * mapping{nullptr};
+    size_t mapping_size{0};
+    std::unordered_map<std::string, FastaIndexEntry> contigs{};
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    ReferenceGenome()                                    = default; //!< Defaulted.
+    ReferenceGenome(ReferenceGenome const &)             = delete;  //!< Deleted, the mapping is owned.
+    ReferenceGenome(ReferenceGenome && other) noexcept;
+    ReferenceGenome & operator=(ReferenceGenome const &) = delete;  //!< Deleted, the mapping is owned.
+    ReferenceGenome & operator=(ReferenceGenome && other) noexcept;
+    ~ReferenceGenome();
+
+    /*! \brief Memory-maps a FASTA file and reads or builds its index.
+     *
+     * \param[in] fasta_file_path - path to the uncompressed FASTA file
+     *
+     * \throws std::runtime_error if the file cannot be mapped, is compressed or if its index is invalid, e.g. the
+     *         lines of a sequence differ in length.
+     */
+    explicit ReferenceGenome(std::filesystem::path const & fasta_file_path);
+    //!\}
+
+    /*! \brief Returns the index entry of a reference sequence.
+     *
+     * \param[in] name - the name of the reference sequence, i.e. the FASTA header up to the first whitespace
+     *
+     * \returns A pointer to the entry or nullptr, if the reference sequence is not part of the genome.
+     */
+    FastaIndexEntry const * find(std::string const & name) const;
+
+    /*! \brief Copies the bases of a reference sequence without the line breaks.
+     *
+     * \param[in] contig - the index entry of the reference sequence, see find()
+     * \param[in] begin  - 0-based start position
+     * \param[in] end    - 0-based end position (exclusive), at most contig.length
+     * \param[out] bases - the bases of [begin, end)
+     */
+    void copy_bases(FastaIndexEntry const & contig, uint64_t const begin, uint64_t const end, char * bases) const;
+};
+
+/*! \brief A cache of the recently read pages of one reference sequence of a ReferenceGenome.
+ *
+ * \details The records of the VCF output are ordered by reference sequence, thus the cache holds only pages of the
+ *          current reference sequence and drops them, when another reference sequence is read. The bases of a page
+ *          are converted to seqan3::dna5 once and the least recently used page is replaced. A cache is not
+ *          thread-safe, thus every thread uses its own cache of a shared ReferenceGenome.
+ */
+class ReferenceGenomeCache
+{
+public:
+    //! \brief The number of bases of a page.
+    static constexpr uint64_t page_size = 16384;
+    //! \brief The number of cached pages.
+    static constexpr size_t amount_pages = 8;
+
+private:
+    struct Page
+    {
+        uint64_t index{UINT64_MAX};
+        uint64_t last_use{0};
+        seqan3::dna5_vector bases{};
+    };
+
+    ReferenceGenome const * genome{nullptr};
+    InternedString contig_name{};
+    FastaIndexEntry const * contig{nullptr};
+    std::array<Page, amount_pages> pages{};
+    uint64_t amount_uses{0};
+
+    //! \brief Returns the page with the given index of the current reference sequence, which is read if it is missing.
+    Page const & get_page(uint64_t const index);
+
+    //! \brief Makes the given reference sequence the current one and drops the pages of the previous one.
+    void select_contig(InternedString const & name);
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    ReferenceGenomeCache(ReferenceGenomeCache const &)             = default; //!< Defaulted.
+    ReferenceGenomeCache(ReferenceGenomeCache &&)                  = default; //!< Defaulted.
+    ReferenceGenomeCache & operator=(ReferenceGenomeCache const &) = default; //!< Defaulted.
+    ReferenceGenomeCache & operator=(ReferenceGenomeCache &&)      = default; //!< Defaulted.
+    ~ReferenceGenomeCache()                                        = default; //!< Defaulted.
+
+    //! \brief Construct a cache of a genome, which has to outlive the cache.
+    explicit ReferenceGenomeCache(ReferenceGenome const & genome) : genome{&genome}
+    {}
+    //!\}
+
+    //! \brief Returns whether a reference sequence is part of the genome.
+    bool contains(InternedString const & name);
+
+    /*! \brief Appends the bases of a region of a reference sequence to a sequence.
+     *
+     * \param[in] name          - the name of the reference sequence
+     * \param[in] begin         - 0-based start position
+     * \param[in] end           - 0-based end position (exclusive)
+     * \param[in, out] sequence - the sequence, to which the bases are appended
+     *
+     * \details Positions outside of the reference sequence and reference sequences, which are not part of the genome,
+     *          are appended as N.
+     */
+    void append_bases(InternedString const & name, int64_t const begin, int64_t const end,
+                      seqan3::dna5_vector & sequence);
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>      // for int64_t and uint64_t
+#include <deque>        // for std::deque
+#include <filesystem>   // for std::filesystem::path
+#include <fstream>      // for std::ofstream
+#include <future>       // for std::future
+#include <map>          // for std::map
+#include <streambuf>    // for std::streambuf
+#include <string>
+#include <string_view>  // for std::string_view
+#include <vector>
+
+/*! \brief Builds a tabix (.tbi) or CSI (.csi) index of a VCF file from its uncompressed text, while the file is written
+ *         by a BgzfStreambuf.
+ *
+ * \details The records are parsed like tabix does for VCF files: a record spans from POS to POS + length(REF) - 1 or
+ *          to the END value of the INFO column, if it is larger. The records are assigned to the bins of the
+ *          hierarchical binning scheme of htslib with windows of 16 kbp. The bins and the linear index are built
+ *          with the offsets in the uncompressed text, which are translated into virtual file offsets, when the index
+ *          is written. A tabix index supports reference sequences of up to 2^29 bp, for longer reference sequences a
+ *          CSI index with more levels is built. The records of each reference sequence are expected to be sorted by
+ *          their positions and the reference sequences to be contiguous, which is checked by is_valid().
+ */
+class VcfIndexBuilder
+{
+private:
+    //! \brief A range [begin, end) of offsets in the uncompressed text.
+    struct Chunk
+    {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    //! \brief The bins with their chunks and the smallest offset of each 16 kbp window (linear index).
+    struct ReferenceIndex
+    {
+        std::map<uint32_t, std::vector<Chunk>> bins{};
+        std::vector<uint64_t> linear_index{};
+    };
+
+    static constexpr int32_t min_shift = 14;
+    int32_t depth{5};
+    bool csi{false};
+    bool sorted{true};
+    int64_t previous_begin{0};
+
+    std::vector<std::string> names{};
+    std::vector<ReferenceIndex> references{};
+    std::string incomplete_line{};
+    uint64_t text_offset{0};
+
+    //! \brief Adds a complete line (without the newline), which starts at the given offset of the uncompressed text.
+    void add_line(std::string_view const line, uint64_t const begin, uint64_t const end);
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    VcfIndexBuilder()                                    = default; //!< Defaulted.
+    VcfIndexBuilder(VcfIndexBuilder const &)             = default; //!< Defaulted.
+    VcfIndexBuilder(VcfIndexBuilder &&)                  = default; //!< Defaulted.
+    VcfIndexBuilder & operator=(VcfIndexBuilder const &) = default; //!< Defaulted.
+    VcfIndexBuilder & operator=(VcfIndexBuilder &&)      = default; //!< Defaulted.
+    ~VcfIndexBuilder()                                   = default; //!< Defaulted.
+
+    /*! \brief Construct an empty index.
+     *
+     * \param[in] max_reference_length - the length of the longest reference sequence, which decides between a tabix
+     *                                   and a CSI index
+     */
+    explicit VcfIndexBuilder(int64_t const max_reference_length);
+    //!\}
+
+    //! \brief Returns the file extension of the index, i.e. ".tbi" or ".csi".
+    std::string get_extension() const;
+
+    /*! \brief Returns false, if the records of a reference sequence were interrupted by another reference sequence or
+     *         if the begin of a record is smaller than the one of the previous record.
+     */
+    bool is_valid() const;
+
+    //! \brief Adds the next part of the uncompressed text of the VCF file.
+    void add_text(std::string_view const text);
+
+    /*! \brief Writes the index as BGZF compressed file.
+     *
+     * \param[in] index_file_path - path of the index file
+     * \param[in] block_offsets   - the offset of each BGZF block in the compressed file and the offset of the end of the
+     *                              last block, see BgzfStreambuf::get_block_offsets()
+     *
+     * \throws std::runtime_error if the file cannot be written.
+     */
+    void write(std::filesystem::path const & index_file_path, std::vector<uint64_t> const & block_offsets) const;
+};
+
+/*! \brief A stream buffer, which writes a BGZF compressed file and compresses the blocks concurrently.
+ *
+ * \details The text is cut into blocks of block_size bytes, only the last block may be shorter. Flushing the stream
+ *          does not end a block, thus the position of any byte in the compressed file can be computed from the
+ *          offsets of the blocks. Up to `threads` blocks are compressed concurrently and the compressed blocks are
+ *          written in their original order. If an index builder is given, it gets the text of each block in order.
+ */
+class BgzfStreambuf : public std::streambuf
+{
+private:
+    std::ofstream file{};
+    std::vector<char> buffer{};
+    std::deque<std::future<std::string>> compressed_blocks{};
+    std::vector<uint64_t> block_offsets{};
+    uint64_t file_offset{0};
+    size_t threads{1};
+    VcfIndexBuilder * index{nullptr};
+    bool closed{false};
+
+    //! \brief Passes the buffered text to the index and queues it for compression.
+    void emit_block();
+
+    //! \brief Writes the first of the queued blocks, after its compression finished.
+    void write_next_block();
+
+    //! \brief Writes a compressed block and records its offset.
+    void write_block(std::string const & block);
+
+protected:
+    int_type overflow(int_type const character) override;
+
+public:
+    //! \brief The amount of uncompressed bytes per BGZF block, as used by htslib.
+    static constexpr size_t block_size = 0xff00;
+
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    BgzfStreambuf(BgzfStreambuf const &)             = delete;  //!< Deleted, the file and the queue are owned.
+    BgzfStreambuf(BgzfStreambuf &&)                  = delete;  //!< Deleted, the file and the queue are owned.
+    BgzfStreambuf & operator=(BgzfStreambuf const &) = delete;  //!< Deleted, the file and the queue are owned.
+    BgzfStreambuf & operator=(BgzfStreambuf &&)      = delete;  //!< Deleted, the file and the queue are owned.
+    ~BgzfStreambuf() override;
+
+    /*! \brief Opens the output file.
+     *
+     * \param[in] file_path - path of the compressed file
+     * \param[in] threads   - the maximal amount of blocks, which are compressed concurrently
+     * \param[in] index     - an index builder, which gets the uncompressed text, or nullptr
+     *
+     * \throws std::runtime_error if the file cannot be opened.
+     */
+    BgzfStreambuf(std::filesystem::path const & file_path, size_t const threads, VcfIndexBuilder * index = nullptr);
+    //!\}
+
+    /*! \brief Writes all remaining blocks and the end-of-file marker and closes the file.
+     *
+     * \throws std::runtime_error if the file cannot be written.
+     */
+    void close();
+
+    //! \brief Returns the offset of each written block and, after close(), the offset of the end-of-file marker.
+    std::vector<uint64_t> const & get_block_offsets() const;
+};
@@ -2,13 +2,14 @@
 
 #include <filesystem>               // for filesystem
 #include <fstream>
+#include <functional>               // for std::function
 #include <map>
 #include <vector>
 
-#include "iGenVar.hpp"              // for struct cmd_arguments
-#include "structures/junction.hpp"  // for class Junction
-
-#include "bamit/all.hpp"
+#include "iGenVar.hpp"                      // for struct cmd_arguments
+#include "structures/alignment_index.hpp"   // for class AlignmentIndex
+#include "structures/genomic_region.hpp"    // for struct GenomicRegion
+#include "structures/junction.hpp"          // for class Junction
 
 /*! \brief Reads the header of the input file. Checks if input file is sorted and reads the reference sequence
  *         dictionary. Stores the reference sequence lengths in parameter `reference_lengths` and returns the list of
@@ -21,20 +22,32 @@ std::deque<std::string> read_header_information(auto & alignment_file,
                                                 std::map<std::string, int32_t> & references_lengths);
 
 /*! \brief Support function for a atomic file write operation.\n
- *         Note: The functionality of the variables is described for BAMIT.
+ *         Note: The functionality of the variables is described for the alignment index.
  *
- * \param[in] tmp_file_path - tmp file path (ending: `.bit.tmp`)
- * \param[in] file_path - the path for the BAMIT file (ending: `.bit`)
+ * \param[in] tmp_file_path - tmp file path (ending: `.igvi.tmp`)
+ * \param[in] file_path - the path for the alignment index file (ending: `.igvi`)
  */
 void safe_sync_rename(std::filesystem::path const & tmp_file_path, std::filesystem::path const & file_path);
 
-/*! \brief Attempts to load a bamit index having the same name as a given input file, with ".bit" appended at the end.
- *         If this file does not exist, it will create the index itself and save it to that file.
+/*! \brief Attempts to memory-map an alignment index having the same name as a given input file, with ".igvi" appended
+ *         at the end. If this file does not exist or is invalid, it will create the index itself and save it to that
+ *         file.
  *
  * \param[in] input_path - the path to the short/long read alignment file.
- * \return A bamit::index tree.
+ * \return The alignment index.
  */
-std::vector<std::unique_ptr<bamit::IntervalNode>> load_or_create_index(std::filesystem::path const & input_path);
+AlignmentIndex load_or_create_index(std::filesystem::path const & input_path);
+
+/*! \brief Collects the regions given on the command line, to which the detection of junctions is restricted.
+ *
+ * \param[in] args - command line arguments:\n
+ *                   **args.regions** - regions in the format chr:start-end, chr:start or chr\n
+ *                   **args.regions_bed_file_path** - path to a BED file with regions
+ *
+ * \returns The regions of `args.regions` followed by the regions of the BED file, empty if the whole genome is analysed.
+ * \throws std::invalid_argument if a region is malformed.
+ */
+std::vector<GenomicRegion> get_regions(cmd_arguments const & args);
 
 /*! \brief Detects junctions between distant genomic positions by analyzing a short read alignment file (sam/bam). The
  *         detected junctions are stored in a vector.
@@ -45,12 +58,16 @@ std::vector<std::unique_ptr<bamit::IntervalNode>> load_or_create_index(std::file
  *                         **args.alignment_short_reads_file_path** - short reads input file, path to the sam/bam file\n
  *                         **args.methods** - list of methods for detecting junctions
  *                            (0: cigar_string, 1: split_read, 2: read_pairs, 3: read_depth) - *default: all methods*\n
+ *                         **args.regions**, **args.regions_bed_file_path** - regions to restrict the detection to,
+ *                            see get_regions() - *default: whole genome*
  *
  *
  * \details Detects junctions from the CIGAR strings and supplementary alignment tags of read alignment records.
  *          We filter unmapped alignments, secondary alignments, duplicates and alignments with low mapping quality.
  *          Then, the CIGAR string of all remaining alignments is analyzed.
  *          For primary alignments, also the split read information is analyzed.
+ *          If regions are given, only the alignments overlapping them are read, using the alignment index to seek to them.
+ *          Otherwise, a missing alignment index is built from the records read for the detection and saved at the end.
  */
 void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
                                               std::map<std::string, int32_t> & references_lengths,
@@ -68,14 +85,46 @@ void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
  *                         **args.min_var_length** - minimum length of variants to detect
  *                            (expected to be non-negative) - *default: 30 bp*\n
  *                         **args.max_overlap** - maximum overlap between alignment segments
- *                            (expected to be non-negative) - *default: 10 bp*
+ *                            (expected to be non-negative) - *default: 10 bp*\n
+ *                         **args.threads** - number of threads used for analysing the alignments - *default: 1*\n
+ *                         **args.regions**, **args.regions_bed_file_path** - regions to restrict the detection to,
+ *                            see get_regions() - *default: whole genome*
  *
  *
  * \details Detects junctions from the CIGAR strings and supplementary alignment tags of read alignment records.
  *          We filter unmapped alignments, secondary alignments, duplicates and alignments with low mapping quality.
  *          Then, the CIGAR string of all remaining alignments is analyzed.
  *          For primary alignments, also the split read information is analyzed.
+ *          If regions are given, only the alignments overlapping them are read, using the alignment index to seek to them.
+ *          If more than one thread is given, the alignments of each reference sequence are analyzed by worker threads
+ *          and the resulting junctions are merged in the order of the input file.
  */
 void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
                                              std::map<std::string, int32_t> & references_lengths,
                                              cmd_arguments const & args);
+
+/*! \brief Detects junctions in a long read alignment file (sam/bam) and hands them over in sorted batches, such that
+ *         only a bounded number of junctions has to be kept in memory.
+ *
+ * \param[in, out]  references_lengths - reference sequence dictionary parsed from \@SQ header lines
+ * \param[in]       args - command line arguments:\n
+ *                         **args.alignment_long_reads_file_path** - long reads input file, path to the sam/bam file\n
+ *                         **args.methods** - list of methods for detecting junctions
+ *                            (0: cigar_string, 1: split_read, 2: read_pairs, 3: read_depth) - *default: all methods*\n
+ *                         **args.partition_max_distance** - maximum distance between junctions in the same partition
+ *                            - *default: 50 bp*\n
+ *                         **args.regions**, **args.regions_bed_file_path** - regions to restrict the detection to,
+ *                            see get_regions() - *default: whole genome*
+ * \param[in]       header_read - called once after the reference sequence dictionary has been read
+ * \param[in]       process_batch - called with each batch of sorted junctions
+ *
+ * \details The junctions are sorted by a JunctionSorter in runs of 1,000,000 junctions, which are spilled to a
+ *          temporary junction dump. The split reads of an alignment add junctions on any reference sequence, e.g. the
+ *          junction between two supplementary alignments on chr1 is found at the primary alignment on chr2, thus no
+ *          reference sequence is complete before the whole file has been read. Afterwards, the runs are merged in the
+ *          order of batch mode and handed over in batches of whole partitions with at least 100,000 junctions.
+ */
+void stream_junctions_in_long_reads_sam_file(std::map<std::string, int32_t> & references_lengths,
+                                             cmd_arguments const & args,
+                                             std::function<void()> const & header_read,
+                                             std::function<void(std::vector<Junction> &)> const & process_batch);
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <memory>       // for std::unique_ptr
+#include <optional>     // for std::optional
+#include <ostream>      // for std::ostream
+
 #include <bio/var_io/writer.hpp>
 
-#include "iGenVar.hpp"              // for cmd_arguments
-#include "structures/cluster.hpp"   // for class Cluster
+#include "iGenVar.hpp"                          // for cmd_arguments
+#include "structures/cluster.hpp"               // for class Cluster
+#include "structures/reference_genome.hpp"      // for class ReferenceGenome and class ReferenceGenomeCache
+#include "variant_detection/bgzf_output.hpp"    // for class BgzfStreambuf and class VcfIndexBuilder
 
 /*! \brief Gets the current time and transforms it in a nice readable way for the vcf header line filedate.
  *
@@ -33,18 +39,106 @@ void write_header(std::map<std::string, int32_t> & references_lengths,
  *                                                               (expected to be non-negative) - *default: 5 bp*\n
  *                            **args.min_qual** - minimum quality (amount of supporting reads) of a structural variant
  *                                                (expected to be non-negative) - *default: 1 supporting read*\n
- * \param[in, out] found_SV - will set to true, if an SV was found
- * \param[in, out] record   - vector of SV records
+ * \param[in, out] reference_cache - cache of the reference genome, if no genome is given the REF column is N
+ * \param[in, out] found_SV        - will set to true, if an SV was found
+ * \param[in, out] record          - vector of SV records
  *
  * \details Extracts genomic variants from given junction clusters.
  *          The quality of an SV is estimated based on the size of the cluster
  *          (i.e. the number of reads supporting the SV).
+ *          With a reference genome, the REF column holds the base at POS. A deletion is written with its sequence,
+ *          i.e. the REF column holds the base at POS followed by the deleted bases and the ALT column the base at POS.
+ *          For a reference sequence, which is missing in the genome, the REF column is N and a deletion keeps its
+ *          symbolic ALT <DEL>.
  */
 void write_record(Cluster const & cluster,
                   cmd_arguments const & args,
+                  std::optional<ReferenceGenomeCache> & reference_cache,
                   bool & found_SV,
                   bio::var_io::default_record<> & record);
 
+/*! \brief The VCF output, which is either plain text, BGZF compressed text with a tabix index for a file path ending in
+ *         .gz or binary BCF for a file path ending in .bcf.
+ *
+ * \details The compressed output is written by a BgzfStreambuf, which compresses args.threads blocks concurrently, and
+ *          the index is built on the fly from the written text. It is written next to the VCF file by close(), as
+ *          "<output_file_path>.tbi" or, for reference sequences longer than 2^29 bp, as "<output_file_path>.csi".
+ *          The BCF output is encoded by the writer of b.i.o., which selects the format by the file extension and writes
+ *          the typed values of the records without formatting them as text. Its BGZF compression uses
+ *          seqan3::contrib::bgzf_thread_count threads.
+ *          If args.genome_file_path is given, the reference genome is opened for the REF column of the records.
+ */
+class VariantWriter
+{
+private:
+    // The members are destroyed in reverse order, i.e. the writer before the streams it writes to.
+    std::unique_ptr<VcfIndexBuilder> index{};
+    std::unique_ptr<BgzfStreambuf> compressed_buffer{};
+    std::unique_ptr<std::ostream> compressed_stream{};
+    std::optional<bio::var_io::writer<>> writer{};
+    std::filesystem::path output_file_path{};
+    std::unique_ptr<ReferenceGenome> genome{};
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    VariantWriter(VariantWriter const &)             = delete;  //!< Deleted, the writer refers to the owned streams.
+    VariantWriter(VariantWriter &&)                  = delete;  //!< Deleted, the writer refers to the owned streams.
+    VariantWriter & operator=(VariantWriter const &) = delete;  //!< Deleted, the writer refers to the owned streams.
+    VariantWriter & operator=(VariantWriter &&)      = delete;  //!< Deleted, the writer refers to the owned streams.
+    ~VariantWriter();                                           //!< Closes the output, errors are ignored.
+
+    /*! \brief Opens the VCF output and sets the header.
+     *
+     * \param[in] references_lengths - reference sequence dictionary parsed from \@SQ header lines
+     * \param[in] args               - command line arguments:\n
+     *                                 **args.vcf_sample_name - Name of the sample for the vcf header line*\n
+     *                                 **args.threads** - number of threads for the compression of the output\n
+     *                                 **args.genome_file_path** - path to the reference genome (FASTA), which is
+     *                                                             optional\n
+     * \param[in] output_file_path   - output file path with the extension .vcf, .vcf.gz or .bcf, if empty the
+     *                                 VCF is written to standard output
+     *
+     * \throws std::runtime_error if the output file or the reference genome cannot be opened.
+     */
+    VariantWriter(std::map<std::string, int32_t> & references_lengths,
+                  cmd_arguments const & args,
+                  std::filesystem::path const & output_file_path);
+    //!\}
+
+    //! \brief Returns the VCF writer that is ready for writing records.
+    bio::var_io::writer<> & get_writer();
+
+    //! \brief Returns the reference genome or nullptr, if no reference genome is given.
+    ReferenceGenome const * get_genome() const noexcept
+    {
+        return genome.get();
+    }
+
+    /*! \brief Writes the remaining records and, for a compressed output, the end of the file and the index.
+     *
+     * \throws std::runtime_error if the output or the index cannot be written.
+     */
+    void close();
+};
+
+/*! \brief Detects genomic variants from junction clusters and writes them to an opened VCF writer.
+ *
+ * \param[in] clusters    - input junction clusters
+ * \param[in] args        - command line arguments, see find_and_output_variants()
+ * \param[in, out] writer - the VCF output
+ *
+ * \returns The number of written SVs.
+ *
+ * \details With args.threads > 1, the records of chunks of clusters are formatted concurrently and a reorder buffer
+ *          passes them to the writer in the order of the clusters, thus the output is identical for any number of
+ *          threads. Every thread reads the reference genome of the writer through its own ReferenceGenomeCache.
+ */
+size_t output_variants(std::vector<Cluster> const & clusters,
+                       cmd_arguments const & args,
+                       VariantWriter & writer);
+
 /*! \brief Detects genomic variants from junction clusters and prints them in output file in VCF format.
  *
  * \param[in] references_lengths - reference sequence dictionary parsed from \@SQ header lines
@@ -61,6 +155,9 @@ void write_record(Cluster const & cluster,
  *                                 **args.min_qual** - minimum quality (amount of supporting reads) of a structural
  *                                                     variant (expected to be non-negative)
  *                                                   - *default: 1 supporting read*\n
+ *                                 **args.threads** - number of threads for formatting and compressing the records\n
+ *                                 **args.genome_file_path** - path to the reference genome (FASTA) for the REF
+ *                                                             column, which is optional\n
  ** \param[in] output_file_path  - output file path
  *
  * \details Extracts genomic variants from given junction clusters.
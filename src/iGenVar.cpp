@@ -1,14 +1,19 @@
 #include "iGenVar.hpp"
 
 #include <map>
+#include <optional>
+#include <utility>
 
 #include <seqan3/contrib/stream/bgzf_stream_util.hpp>       // for bgzf_thread_count
 #include <seqan3/core/debug_stream.hpp>                     // for seqan3::debug_stream
-#include <seqan3/io/sequence_file/input.hpp>                // for sequence input file extensions
+#include <seqan3/io/sequence_file/format_fasta.hpp>         // for the FASTA file extensions
 
+#include "modules/clustering/candidate_selection_based_on_voting_method.hpp" // for the voting clustering method
 #include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
+#include "modules/clustering/self_balancing_binary_tree_method.hpp" // for the self-balancing binary tree method
 #include "modules/clustering/simple_clustering_method.hpp"          // for the simple clustering method
 #include "structures/cluster.hpp"                                   // for class Cluster
+#include "structures/junction_dump.hpp"                             // for class JunctionDump and JunctionDumpWriter
 #include "variant_detection/snp_indel_detection.hpp"                // for detect_snp_and_indel
 #include "variant_detection/variant_detection.hpp"                  // for detect_junctions_in_long_reads_sam_file()
 #include "variant_detection/variant_output.hpp"                     // for find_and_output_variants()
@@ -39,13 +44,40 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
                       seqan3::input_file_validator{{"sam", "bam"}} );
     parser.add_option(args.genome_file_path,
                       'g', "input_genome",
-                      "Input the sequence of the reference genome.",
+                      "Input the sequence of the reference genome in FASTA format. It fills the REF column of the VCF "
+                      "output and is read by random access with its FASTA index (.fai), which is built on the fly if it "
+                      "is missing. It does not change the detection of the variants.",
                       seqan3::option_spec::standard,
-                      seqan3::input_file_validator<seqan3::sequence_file_input<>>{} );
+                      seqan3::input_file_validator{seqan3::format_fasta::file_extensions} );
+    parser.add_flag(args.snp_indel_detection, '\0', "snp_indel",
+                    "If you set this flag, the active regions of SNPs and indels are detected in the short read file "
+                    "instead of its junctions, thus no SVs of the short reads are output. Only available for short "
+                    "read files.");
+    parser.add_option(args.input_junctions_file_path, '\0', "input_junctions",
+                      "Input the junctions from a binary dump (.igvd) of --junctions or --clusters of a previous run "
+                      "instead of detecting them in alignment files. The junctions are clustered and output with the "
+                      "current parameters.",
+                      seqan3::option_spec::standard,
+                      seqan3::input_file_validator{{"igvd"}});
     parser.add_option(args.output_file_path, 'o', "output",
-                      "The path of the vcf output file. If no path is given, will output to standard output.",
+                      "The path of the vcf output file. If no path is given, will output to standard output. A path "
+                      "ending in .gz is written compressed in the BGZF format together with a tabix index (.tbi or "
+                      ".csi for very long reference sequences), a path ending in .bcf is written in the binary BCF "
+                      "format.",
+                      seqan3::option_spec::standard,
+                      seqan3::output_file_validator{seqan3::output_file_open_options::open_or_create,
+                                                    {"vcf", "vcf.gz", "bcf"}});
+
+    // Options - Regions:
+    parser.add_option(args.regions, '\0', "region",
+                      "Restrict the detection to a region in the format chr:start-end, chr:start or chr (1-based, "
+                      "inclusive). Can be given multiple times. The alignments are read via the index of the alignment "
+                      "file (.igvi), which is created if it does not exist.",
+                      seqan3::option_spec::standard);
+    parser.add_option(args.regions_bed_file_path, '\0', "regions_bed",
+                      "Restrict the detection to the regions of a BED file, like --region.",
                       seqan3::option_spec::standard,
-                      seqan3::output_file_validator{seqan3::output_file_open_options::open_or_create, {"vcf"}});
+                      seqan3::input_file_validator{{"bed"}});
 
     // Options - VCF:
     parser.add_option(args.vcf_sample_name, 's', "vcf_sample_name",
@@ -54,7 +86,8 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
 
     // Options - Other parameters:
     parser.add_option(args.threads, 't', "threads",
-                      "Specify the number of decompression threads used for reading BAM files.",
+                      "Specify the number of threads used for decompressing BAM files, for analysing long read "
+                      "alignments, for clustering and for formatting the VCF records.",
                       seqan3::option_spec::standard);
     parser.add_flag(gVerbose, 'v', "verbose",
                     "If you set this flag, we provide additional details about what iGenVar does. The detailed output "
@@ -62,11 +95,14 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
 
     // Options - Optional output:
     parser.add_option(args.junctions_file_path, 'a', "junctions",
-                      "The path of the optional junction output file. If no path is given, junctions will not be output.",
+                      "The path of the optional junction output file. If no path is given, junctions will not be "
+                      "output. A path ending in .igvd is written in a binary format, which can be read by "
+                      "--input_junctions.",
                       seqan3::option_spec::advanced,
                       seqan3::output_file_validator{seqan3::output_file_open_options::open_or_create});
     parser.add_option(args.clusters_file_path, 'b', "clusters",
-                      "The path of the optional cluster output file. If no path is given, clusters will not be output.",
+                      "The path of the optional cluster output file. If no path is given, clusters will not be output. "
+                      "A path ending in .igvd is written in a binary format, which can be read by --input_junctions.",
                       seqan3::option_spec::advanced,
                       seqan3::output_file_validator{seqan3::output_file_open_options::open_or_create});
 
@@ -123,6 +159,99 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
                       "Specify the distance cutoff for the hierarchical clustering. "
                       "This value needs to be non-negative.",
                       seqan3::option_spec::advanced);
+    parser.add_flag(args.approximate_large_partitions, '\0', "approximate_large_partitions",
+                    "If you set this flag, the hierarchical clustering (1) clusters groups of more than 200 nearby "
+                    "junctions by an approximate average linkage instead of their full distance matrix, whose memory "
+                    "grows quadratically with the size of the group. The clusters can differ from the exact average "
+                    "linkage.",
+                    seqan3::option_spec::advanced);
+
+    // Options - Pipeline:
+    parser.add_flag(args.streaming, '\0', "streaming",
+                    "If you set this flag, the long read file is processed in streaming mode: instead of storing all "
+                    "junctions in memory, the junctions are spilled to a temporary file in sorted runs and clustered "
+                    "in batches of whole partitions after the file has been read. The voting clustering method (3) can "
+                    "cluster differently at the borders of the batches. Not available for short read files.",
+                    seqan3::option_spec::advanced);
+}
+
+/*! \brief Clusters junctions by the clustering method given in the command line arguments.
+ *
+ * \param[in] junctions - a vector of sorted junctions, which may be moved into the clusters
+ * \param[in] args - command line arguments, see detect_variants_in_alignment_file()
+ *
+ * \returns Returns sorted clusters of sorted junctions.
+ */
+std::vector<Cluster> cluster_junctions(std::vector<Junction> junctions, cmd_arguments const & args)
+{
+    std::vector<Cluster> clusters;
+    switch (args.clustering_method)
+    {
+        case 0: // simple_clustering
+            clusters = simple_clustering_method(junctions);
+            break;
+        case 1: // hierarchical clustering
+            clusters = hierarchical_clustering_method(std::move(junctions),
+                                                      args.partition_max_distance,
+                                                      args.hierarchical_clustering_cutoff,
+                                                      args.threads,
+                                                      args.approximate_large_partitions);
+            break;
+        case 2: // self-balancing_binary_tree,
+            clusters = self_balancing_binary_tree_method(std::move(junctions),
+                                                         args.partition_max_distance,
+                                                         args.hierarchical_clustering_cutoff);
+            break;
+        case 3: // candidate_selection_based_on_voting
+            clusters = candidate_selection_based_on_voting_method(junctions, args.hierarchical_clustering_cutoff);
+            break;
+    }
+    return clusters;
+}
+
+/*! \brief Refines the junction clusters by the refinement method given in the command line arguments. As no
+ *         refinement method is implemented yet, only the selection is reported.
+ *
+ * \param[in] args - command line arguments, see detect_variants_in_alignment_file()
+ */
+void refine_clusters(cmd_arguments const & args)
+{
+    switch (args.refinement_method)
+    {
+        case 0: // no refinement
+            seqan3::debug_stream << "No refinement was selected.\n";
+            break;
+        case 1: // sViper_refinement_method
+            seqan3::debug_stream << "The sViper refinement method is not yet implemented.\n";
+            break;
+        case 2: // sVirl_refinement_method
+            seqan3::debug_stream << "The sVirl refinement method is not yet implemented.\n";
+            break;
+    }
+}
+
+/*! \brief Opens an optional output file for junctions or clusters.
+ *
+ * \param[in] file_path - the path of the output file
+ *
+ * \returns The opened output file stream.
+ */
+std::ofstream open_intermediate_result_file(std::filesystem::path const & file_path)
+{
+    std::ofstream file{file_path};
+
+    // LCOV_EXCL_START
+    if (!file.good() || !file.is_open())
+        throw std::runtime_error{"Could not open file '" + file_path.string() + "' for writing."};
+    // LCOV_EXCL_STOP
+
+    return file;
+}
+
+//! \brief Returns whether the junctions or clusters are written to a binary dump instead of a text file.
+bool is_dump_file(std::filesystem::path const & file_path)
+{
+    return file_path.extension() == ".igvd";
 }
 
 void detect_variants_in_alignment_file(cmd_arguments const & args)
@@ -141,9 +270,17 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
                                 " use a coordinate converter beforehand.\n";
     }
 
+    // junctions of a previous run
+    if (!args.input_junctions_file_path.empty())
+    {
+        seqan3::debug_stream << "Read junctions from a dump...\n";
+        JunctionDump const dump{args.input_junctions_file_path};
+        junctions = dump.junctions();
+        references_lengths = dump.references_lengths();
+    }
+
     // short reads
-    // TODO (joergi-w 30.09.2021) Control the selection with the 'method' parameter, not the availability of a genome.
-    if (!args.alignment_short_reads_file_path.empty() && args.genome_file_path.empty())
+    if (!args.alignment_short_reads_file_path.empty() && !args.snp_indel_detection)
     {
         seqan3::debug_stream << "Detect junctions in short reads...\n";
         detect_junctions_in_short_reads_sam_file(junctions, references_lengths, args);
@@ -156,8 +293,8 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
         detect_junctions_in_long_reads_sam_file(junctions, references_lengths, args);
     }
 
-    // SNPs and indels for short reads; genome must be given
-    if (!args.alignment_short_reads_file_path.empty() && !args.genome_file_path.empty())
+    // SNPs and indels for short reads
+    if (!args.alignment_short_reads_file_path.empty() && args.snp_indel_detection)
     {
         seqan3::debug_stream << "Detect SNPs and indels in short reads...\n";
         detect_snp_and_indel(args.alignment_short_reads_file_path, args.min_var_length);
@@ -165,15 +302,18 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
 
     std::sort(junctions.begin(), junctions.end());
 
-    if (!args.junctions_file_path.empty())
+    if (is_dump_file(args.junctions_file_path))
     {
-        std::ofstream junctions_file{args.junctions_file_path};
-
-        // LCOV_EXCL_START
-        if (!junctions_file.good() || !junctions_file.is_open())
-            throw std::runtime_error{"Could not open file '" + args.junctions_file_path.string() + "' for writing."};
-        // LCOV_EXCL_STOP
-
+        JunctionDumpWriter junctions_dump{args.junctions_file_path, references_lengths, dump_content::junctions};
+        for (Junction const & junction : junctions)
+        {
+            junctions_dump.add(junction);
+        }
+        junctions_dump.close();
+    }
+    else if (!args.junctions_file_path.empty())
+    {
+        std::ofstream junctions_file = open_intermediate_result_file(args.junctions_file_path);
         for (Junction const & junction : junctions)
         {
             junctions_file << junction << "\n";
@@ -183,36 +323,22 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
 
     seqan3::debug_stream << "Start clustering...\n";
 
-    std::vector<Cluster> clusters;
-    switch (args.clustering_method)
-    {
-        case 0: // simple_clustering
-            clusters = simple_clustering_method(junctions);
-            break;
-        case 1: // hierarchical clustering
-            clusters = hierarchical_clustering_method(junctions,
-                                                      args.partition_max_distance,
-                                                      args.hierarchical_clustering_cutoff);
-            break;
-        case 2: // self-balancing_binary_tree,
-            seqan3::debug_stream << "The self-balancing binary tree clustering method is not yet implemented.\n";
-            break;
-        case 3: // candidate_selection_based_on_voting
-            seqan3::debug_stream << "The candidate selection based on voting clustering method is not yet implemented.\n";
-            break;
-    }
+    std::vector<Cluster> clusters = cluster_junctions(std::move(junctions), args);
 
     seqan3::debug_stream << "Done with clustering. Found " << clusters.size() << " junction clusters.\n";
 
-    if (!args.clusters_file_path.empty())
+    if (is_dump_file(args.clusters_file_path))
     {
-        std::ofstream clusters_file{args.clusters_file_path};
-
-        // LCOV_EXCL_START
-        if (!clusters_file.good() || !clusters_file.is_open())
-            throw std::runtime_error{"Could not open file '" + args.clusters_file_path.string() + "' for writing."};
-        // LCOV_EXCL_STOP
-
+        JunctionDumpWriter clusters_dump{args.clusters_file_path, references_lengths, dump_content::clusters};
+        for (Cluster const & cluster : clusters)
+        {
+            clusters_dump.add(cluster);
+        }
+        clusters_dump.close();
+    }
+    else if (!args.clusters_file_path.empty())
+    {
+        std::ofstream clusters_file = open_intermediate_result_file(args.clusters_file_path);
         for (Cluster const & cluster : clusters)
         {
             clusters_file << cluster << "\n";
@@ -220,22 +346,92 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
         clusters_file.close();
     }
 
-    switch (args.refinement_method)
-    {
-        case 0: // no refinement
-            seqan3::debug_stream << "No refinement was selected.\n";
-            break;
-        case 1: // sViper_refinement_method
-            seqan3::debug_stream << "The sViper refinement method is not yet implemented.\n";
-            break;
-        case 2: // sVirl_refinement_method
-            seqan3::debug_stream << "The sVirl refinement method is not yet implemented.\n";
-            break;
-    }
+    refine_clusters(args);
 
     find_and_output_variants(references_lengths, clusters, args, args.output_file_path);
 }
 
+void detect_variants_in_long_reads_file_streaming(cmd_arguments const & args)
+{
+    // Map of contig names and their length (SN and LN tag of @SQ)
+    std::map<std::string, int32_t> references_lengths{};
+    std::optional<VariantWriter> writer{};
+    std::ofstream junctions_file{};
+    std::ofstream clusters_file{};
+    std::optional<JunctionDumpWriter> junctions_dump{};
+    std::optional<JunctionDumpWriter> clusters_dump{};
+    size_t amount_clusters = 0;
+    size_t amount_SVs = 0;
+
+    if (!args.junctions_file_path.empty() && !is_dump_file(args.junctions_file_path))
+        junctions_file = open_intermediate_result_file(args.junctions_file_path);
+    if (!args.clusters_file_path.empty() && !is_dump_file(args.clusters_file_path))
+        clusters_file = open_intermediate_result_file(args.clusters_file_path);
+
+    // The VCF header and the dumps need the reference sequence dictionary of the alignment file.
+    auto open_writer = [&] ()
+    {
+        writer.emplace(references_lengths, args, args.output_file_path);
+        if (is_dump_file(args.junctions_file_path))
+            junctions_dump.emplace(args.junctions_file_path, references_lengths, dump_content::junctions);
+        if (is_dump_file(args.clusters_file_path))
+            clusters_dump.emplace(args.clusters_file_path, references_lengths, dump_content::clusters);
+    };
+
+    auto process_batch = [&] (std::vector<Junction> & junctions)
+    {
+        if (junctions_file.is_open())
+        {
+            for (Junction const & junction : junctions)
+            {
+                junctions_file << junction << "\n";
+            }
+        }
+        if (junctions_dump)
+        {
+            for (Junction const & junction : junctions)
+            {
+                junctions_dump->add(junction);
+            }
+        }
+
+        std::vector<Cluster> clusters = cluster_junctions(std::move(junctions), args);
+        amount_clusters += clusters.size();
+        junctions.clear();
+
+        if (clusters_file.is_open())
+        {
+            for (Cluster const & cluster : clusters)
+            {
+                clusters_file << cluster << "\n";
+            }
+        }
+        if (clusters_dump)
+        {
+            for (Cluster const & cluster : clusters)
+            {
+                clusters_dump->add(cluster);
+            }
+        }
+
+        amount_SVs += output_variants(clusters, args, *writer);
+    };
+
+    seqan3::debug_stream << "Detect and cluster junctions in long reads in streaming mode...\n";
+    stream_junctions_in_long_reads_sam_file(references_lengths, args, open_writer, process_batch);
+
+    if (writer)
+        writer->close();
+    if (junctions_dump)
+        junctions_dump->close();
+    if (clusters_dump)
+        clusters_dump->close();
+
+    seqan3::debug_stream << "Done with clustering. Found " << amount_clusters << " junction clusters.\n";
+    refine_clusters(args);
+    seqan3::debug_stream << "Detected " << amount_SVs << " SVs.\n";
+}
+
 int main(int argc, char ** argv)
 {
     seqan3::argument_parser myparser{"iGenVar", argc, argv};    // initialise myparser
@@ -254,7 +450,8 @@ int main(int argc, char ** argv)
     }
 
     // Check if we have at least one input file.
-    if (args.alignment_short_reads_file_path.empty() && args.alignment_long_reads_file_path.empty())
+    if (args.alignment_short_reads_file_path.empty() && args.alignment_long_reads_file_path.empty() &&
+        args.input_junctions_file_path.empty())
     {
         seqan3::debug_stream << "[Error] You need to input at least one sam/bam file.\n"
                              << "Please use -i or -input_short_reads to pass a short read file "
@@ -262,6 +459,42 @@ int main(int argc, char ** argv)
         return -1;
     }
 
+    // The junctions are either read from a dump or detected in the alignment files.
+    if (!args.input_junctions_file_path.empty() &&
+        (!args.alignment_short_reads_file_path.empty() || !args.alignment_long_reads_file_path.empty()))
+    {
+        seqan3::debug_stream << "[Error] The junctions can be read either from a dump (--input_junctions) or from "
+                                "sam/bam files, not from both.\n";
+        return -1;
+    }
+
+    // The streaming mode supports only long reads.
+    if (args.streaming &&
+        (!args.alignment_short_reads_file_path.empty() || args.alignment_long_reads_file_path.empty()))
+    {
+        seqan3::debug_stream << "[Error] The streaming mode is only available for long read files (-j).\n";
+        return -1;
+    }
+
+    // The SNP and indel detection supports only short reads.
+    if (args.snp_indel_detection && args.alignment_short_reads_file_path.empty())
+    {
+        seqan3::debug_stream << "[Error] The detection of SNPs and indels is only available for short read files "
+                                "(-i).\n";
+        return -1;
+    }
+
+    // Check that the given regions are valid.
+    try
+    {
+        get_regions(args);
+    }
+    catch (std::exception const & ext)
+    {
+        seqan3::debug_stream << "[Error] " << ext.what() << '\n';
+        return -1;
+    }
+
     // Set the number of decompression threads
     seqan3::contrib::bgzf_thread_count = args.threads;
 
@@ -283,7 +516,10 @@ int main(int argc, char ** argv)
         return -1;
     }
 
-    detect_variants_in_alignment_file(args);
+    if (args.streaming)
+        detect_variants_in_long_reads_file_streaming(args);
+    else
+        detect_variants_in_alignment_file(args);
 
     return 0;
 }
@@ -0,0 +1,202 @@
+#include "modules/clustering/candidate_selection_based_on_voting_method.hpp"
+
+#include <algorithm>                                                // for std::sort
+#include <cmath>                                                    // for std::abs, std::floor and std::log
+#include <limits>                                                   // for std::numeric_limits
+#include <map>                                                      // for std::map
+#include <tuple>                                                    // for std::tie and std::tuple
+
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for sv_class
+
+//! \brief A bucket of quantized coordinates of the junctions of one class.
+struct BucketKey
+{
+    int64_t group;
+    int64_t x;
+    int64_t y;
+
+    friend bool operator==(BucketKey const &, BucketKey const &) = default;
+
+    friend bool operator<(BucketKey const & lhs, BucketKey const & rhs)
+    {
+        return std::tie(lhs.group, lhs.x, lhs.y) < std::tie(rhs.group, rhs.x, rhs.y);
+    }
+};
+
+/*! \brief A hash table with open addressing, which counts the votes per bucket. The buckets are stored contiguously in
+ *         the order of insertion and the slots of the table refer to them.
+ */
+class VoteTable
+{
+public:
+    //! \brief Marks an empty slot and a missing bucket.
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    std::vector<size_t> slots;
+    size_t mask;
+
+    static size_t hash(BucketKey const & key)
+    {
+        // splitmix64 finalizer of the combined coordinates
+        uint64_t h = key.group * 0x9e3779b97f4a7c15ull ^ key.x * 0xbf58476d1ce4e5b9ull ^ key.y * 0x94d049bb133111ebull;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        return h ^ (h >> 31);
+    }
+
+public:
+    struct Bucket
+    {
+        BucketKey key;
+        size_t votes{0};
+        size_t parent{0};
+    };
+
+    std::vector<Bucket> buckets{};
+
+    //! \brief Construct a table for at most `capacity` buckets with a load factor of at most 0.5.
+    explicit VoteTable(size_t const capacity)
+    {
+        size_t size = 16;
+        while (size < 2 * capacity)
+            size *= 2;
+        slots.assign(size, npos);
+        mask = size - 1;
+        buckets.reserve(capacity);
+    }
+
+    //! \brief Returns the index of the bucket with the given key or npos.
+    size_t find(BucketKey const & key) const
+    {
+        for (size_t slot = hash(key) & mask; slots[slot] != npos; slot = (slot + 1) & mask)
+        {
+            if (buckets[slots[slot]].key == key)
+                return slots[slot];
+        }
+        return npos;
+    }
+
+    //! \brief Adds a vote to the bucket with the given key and returns its index.
+    size_t vote(BucketKey const & key)
+    {
+        size_t slot = hash(key) & mask;
+        for (; slots[slot] != npos; slot = (slot + 1) & mask)
+        {
+            if (buckets[slots[slot]].key == key)
+            {
+                ++buckets[slots[slot]].votes;
+                return slots[slot];
+            }
+        }
+        slots[slot] = buckets.size();
+        buckets.push_back(Bucket{key, 1, buckets.size()});
+        return slots[slot];
+    }
+};
+
+std::vector<Cluster> candidate_selection_based_on_voting_method(std::vector<Junction> const & junctions,
+                                                                double const clustering_cutoff)
+{
+    std::vector<Cluster> clusters{};
+    std::vector<size_t> junction_buckets(junctions.size(), VoteTable::npos);
+    VoteTable table{junctions.size()};
+
+    // The groups of junctions, which may be clustered together, i.e. of the same references, orientations and class.
+    using group_key_t = std::tuple<InternedString, strand, InternedString, strand, int32_t>;
+    std::map<group_key_t, int64_t> groups{};
+
+    for (size_t i = 0; i < junctions.size(); ++i)
+    {
+        Junction const & junction = junctions[i];
+        int32_t const junction_class = sv_class(junction);
+        // Junctions of class 0 have the maximal distance to all junctions and a cutoff of 0 merges no junctions.
+        if (junction_class == 0 || clustering_cutoff <= 0)
+        {
+            clusters.emplace_back(std::vector<Junction>{junction});
+            continue;
+        }
+
+        Breakend const & mate1 = junction.get_mate1();
+        Breakend const & mate2 = junction.get_mate2();
+        [[maybe_unused]] auto const [group, inserted] = groups.try_emplace({mate1.seq_name, mate1.orientation,
+                                                                            mate2.seq_name, mate2.orientation,
+                                                                            junction_class},
+                                                                           groups.size());
+        double y{};
+        if (junction_class == 2)
+        {
+            y = mate2.position / 1000.0;
+        }
+        else
+        {
+            int32_t const directed_size = junction.get_inserted_sequence().size() + mate1.position - mate2.position;
+            y = std::log(std::abs(directed_size));
+        }
+        BucketKey const key{group->second,
+                            static_cast<int64_t>(std::floor(mate1.position / 1000.0 / clustering_cutoff)),
+                            static_cast<int64_t>(std::floor(y / clustering_cutoff))};
+        junction_buckets[i] = table.vote(key);
+    }
+
+    // Each bucket points to the bucket with the most votes in its neighbourhood, the smaller bucket wins on ties. Both
+    // criteria are strict, thus following the pointers ends in a local maximum.
+    std::vector<VoteTable::Bucket> & buckets = table.buckets;
+    for (VoteTable::Bucket & bucket : buckets)
+    {
+        for (int64_t dx = -1; dx <= 1; ++dx)
+        {
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                size_t const neighbour = table.find({bucket.key.group, bucket.key.x + dx, bucket.key.y + dy});
+                if (neighbour == VoteTable::npos)
+                    continue;
+                VoteTable::Bucket const & best = buckets[bucket.parent];
+                if (buckets[neighbour].votes > best.votes ||
+                    (buckets[neighbour].votes == best.votes && buckets[neighbour].key < best.key))
+                {
+                    bucket.parent = neighbour;
+                }
+            }
+        }
+    }
+
+    // Find the local maximum of each bucket and compress the paths.
+    std::vector<size_t> path{};
+    for (size_t b = 0; b < buckets.size(); ++b)
+    {
+        size_t root = b;
+        while (buckets[root].parent != root)
+        {
+            path.push_back(root);
+            root = buckets[root].parent;
+        }
+        for (size_t const node : path)
+            buckets[node].parent = root;
+        path.clear();
+    }
+
+    // The junctions of all buckets with the same local maximum form a candidate variant.
+    std::vector<size_t> cluster_of_root(buckets.size(), VoteTable::npos);
+    std::vector<std::vector<Junction>> candidates{};
+    for (size_t i = 0; i < junctions.size(); ++i)
+    {
+        if (junction_buckets[i] == VoteTable::npos)
+            continue;
+        size_t const root = buckets[junction_buckets[i]].parent;
+        if (cluster_of_root[root] == VoteTable::npos)
+        {
+            cluster_of_root[root] = candidates.size();
+            candidates.emplace_back();
+        }
+        candidates[cluster_of_root[root]].push_back(junctions[i]);
+    }
+
+    for (std::vector<Junction> & candidate : candidates)
+    {
+        std::sort(candidate.begin(), candidate.end());
+        clusters.emplace_back(std::move(candidate));
+    }
+    std::sort(clusters.begin(), clusters.end());
+    return clusters;
+}
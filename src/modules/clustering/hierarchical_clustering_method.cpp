@@ -1,93 +1,119 @@
 #include "modules/clustering/hierarchical_clustering_method.hpp"
 
+#include <algorithm>                        // for std::adjacent_find, std::minmax, std::sort and std::ranges::find and max_element
+#include <array>                            // for std::array
+#include <atomic>                           // for std::atomic
+#include <cmath>                            // for std::expm1, std::floor and std::log
+#include <future>                           // for std::async and std::future
+#include <iterator>                         // for std::make_move_iterator
 #include <limits>                           // for std::numeric_limits
-#include <random>                           // for std::mt19937
+#include <map>                              // for std::map
+#include <numeric>                          // for std::exclusive_scan and std::iota
+#include <span>                             // for std::span
+#include <unordered_map>                    // for std::unordered_map
 
 #include <seqan3/core/debug_stream.hpp>
 
 #include "iGenVar.hpp"                      // for global variable gVerbose
 
-#include "fastcluster.h"                    // for hclust_fast
-
-std::vector<std::vector<Junction>> partition_junctions(std::vector<Junction> const & junctions,
-                                                       int32_t const partition_max_distance)
+/*! \brief Appends the sub-partitions of a partition based on the second mate of each junction to `partitions` and sorts
+ *         the junctions of each sub-partition.
+ */
+void append_partitions_based_on_mate2(std::span<Junction> const partition,
+                                      int32_t const partition_max_distance,
+                                      std::vector<std::span<Junction>> & partitions)
 {
-    // Partition based on mate 1
-    std::vector<Junction> current_partition{};
-    std::vector<std::vector<Junction>> current_partition_splitted;
-    std::vector<std::vector<Junction>> final_partitions{};
+    auto const separated = [partition_max_distance] (Junction const & a, Junction const & b)
+    {
+        return b.get_mate2().seq_name != a.get_mate2().seq_name ||
+               b.get_mate2().orientation != a.get_mate2().orientation ||
+               std::abs(b.get_mate2().position - a.get_mate2().position) > partition_max_distance;
+    };
 
-    for (Junction const & junction : junctions)
+    for (auto partition_begin = partition.begin(); partition_begin != partition.end(); )
     {
-        if (current_partition.empty())
-        {
-            current_partition.push_back(junction);
-        }
-        else
-        {
-            if (junction.get_mate1().seq_name != current_partition.back().get_mate1().seq_name ||
-                junction.get_mate1().orientation != current_partition.back().get_mate1().orientation ||
-                std::abs(junction.get_mate1().position - current_partition.back().get_mate1().position)
-                    > partition_max_distance)
-            {
-                // Partition based on mate 2
-                std::sort(current_partition.begin(), current_partition.end(), [](Junction const & a, Junction const & b) {
-                    return a.get_mate2() < b.get_mate2();
-                });
-                current_partition_splitted = split_partition_based_on_mate2(current_partition, partition_max_distance);
-                for (std::vector<Junction> partition : current_partition_splitted)
-                {
-                    final_partitions.push_back(partition);
-                }
-                current_partition.clear();
-            }
-            current_partition.push_back(junction);
-        }
+        auto partition_end = std::adjacent_find(partition_begin, partition.end(), separated);
+        if (partition_end != partition.end())
+            ++partition_end;
+        std::sort(partition_begin, partition_end);
+        partitions.emplace_back(partition_begin, partition_end);
+        partition_begin = partition_end;
     }
-    if (!current_partition.empty())
+}
+
+std::vector<std::span<Junction>> partition_junctions(std::vector<Junction> & junctions,
+                                                     int32_t const partition_max_distance)
+{
+    std::vector<std::span<Junction>> final_partitions{};
+    auto const separated = [partition_max_distance] (Junction const & a, Junction const & b)
+    {
+        return b.get_mate1().seq_name != a.get_mate1().seq_name ||
+               b.get_mate1().orientation != a.get_mate1().orientation ||
+               std::abs(b.get_mate1().position - a.get_mate1().position) > partition_max_distance;
+    };
+
+    // Partition based on mate 1
+    for (auto partition_begin = junctions.begin(); partition_begin != junctions.end(); )
     {
-        std::sort(current_partition.begin(), current_partition.end(), [](Junction a, Junction b) {
+        auto partition_end = std::adjacent_find(partition_begin, junctions.end(), separated);
+        if (partition_end != junctions.end())
+            ++partition_end;
+
+        // Partition based on mate 2
+        std::sort(partition_begin, partition_end, [] (Junction const & a, Junction const & b) {
             return a.get_mate2() < b.get_mate2();
         });
-        current_partition_splitted = split_partition_based_on_mate2(current_partition, partition_max_distance);
-        for (std::vector<Junction> partition : current_partition_splitted)
-        {
-            final_partitions.push_back(partition);
-        }
+        append_partitions_based_on_mate2({partition_begin, partition_end}, partition_max_distance, final_partitions);
+        partition_begin = partition_end;
     }
     return final_partitions;
 }
 
-std::vector<std::vector<Junction>> split_partition_based_on_mate2(std::vector<Junction> const & partition,
-                                                                  int32_t const partition_max_distance)
+std::vector<std::span<Junction>> split_partition_based_on_mate2(std::span<Junction> const partition,
+                                                                int32_t const partition_max_distance)
 {
-    std::vector<Junction> current_partition{};
-    std::vector<std::vector<Junction>> splitted_partition{};
+    std::vector<std::span<Junction>> splitted_partition{};
+    append_partitions_based_on_mate2(partition, partition_max_distance, splitted_partition);
+    return splitted_partition;
+}
 
-    for (Junction const & junction : partition)
+int32_t sv_class(Junction const & junction)
+{
+    if (junction.get_mate1().seq_name != junction.get_mate2().seq_name)
+        return 2;
+    int32_t const directed_size = junction.get_inserted_sequence().size() +
+                                  junction.get_mate1().position -
+                                  junction.get_mate2().position;
+    return (directed_size > 0) - (directed_size < 0);
+}
+
+std::vector<std::span<Junction>> split_partition_by_sv_class(std::span<Junction> const partition)
+{
+    // Junctions of class 0 first, followed by deletions, insertions and inter-chromosomal junctions.
+    auto const rank = [] (Junction const & junction)
     {
-        if (current_partition.empty())
-        {
-            current_partition.push_back(junction);
-        }
-        else
-        {
-            if (junction.get_mate2().seq_name != current_partition.back().get_mate2().seq_name ||
-                junction.get_mate2().orientation != current_partition.back().get_mate2().orientation ||
-                std::abs(junction.get_mate2().position - current_partition.back().get_mate2().position)
-                    > partition_max_distance)
-            {
-                std::sort(current_partition.begin(), current_partition.end());
-                splitted_partition.push_back(current_partition);
-                current_partition.clear();
-            }
-            current_partition.push_back(junction);
-        }
-    }
-    if (!current_partition.empty())
+        int32_t const junction_class = sv_class(junction);
+        return (junction_class == -1) ? 1 : (junction_class == 1) ? 2 : (junction_class == 2) ? 3 : 0;
+    };
+    std::sort(partition.begin(), partition.end(), [&rank] (Junction const & a, Junction const & b)
     {
-        std::sort(current_partition.begin(), current_partition.end());
-        splitted_partition.push_back(current_partition);
+        int32_t const rank_a = rank(a);
+        int32_t const rank_b = rank(b);
+        return rank_a < rank_b || (rank_a == rank_b && a < b);
+    });
+
+    std::vector<std::span<Junction>> splitted_partition{};
+    for (auto partition_begin = partition.begin(); partition_begin != partition.end(); )
+    {
+        int32_t const current_rank = rank(*partition_begin);
+        // Junctions with a directed size of 0 are never clustered with other junctions.
+        auto const partition_end = (current_rank == 0) ? partition_begin + 1 :
+                                   std::find_if(partition_begin, partition.end(), [&] (Junction const & junction)
+                                   {
+                                       return rank(junction) != current_rank;
+                                   });
+        splitted_partition.emplace_back(partition_begin, partition_end);
+        partition_begin = partition_end;
     }
     return splitted_partition;
 }
@@ -133,7 +159,8 @@ double junction_distance(Junction const & lhs, Junction const & rhs)
             double position_distance1 = std::abs(lhs.get_mate1().position - rhs.get_mate1().position) / 1000.0;
             double position_distance2 = std::abs(lhs.get_mate2().position - rhs.get_mate2().position) / 1000.0;
             // TODO (irallia 01.09.2021): std::abs((int)(lhs.get_tandem_dup_count() - rhs.get_tandem_dup_count()))
-            double size_distance = std::abs((double)(lhs.get_inserted_sequence().size() - rhs.get_inserted_sequence().size())) / 1000.0;
+            double size_distance = std::abs((double)lhs.get_inserted_sequence().size() -
+                                            (double)rhs.get_inserted_sequence().size()) / 1000.0;
             return position_distance1 + position_distance2 + size_distance;
         }
     }
@@ -143,91 +170,841 @@ double junction_distance(Junction const & lhs, Junction const & rhs)
     }
 }
 
-inline std::vector<Junction> subsample_partition(std::vector<Junction> const & partition, uint16_t const sample_size)
+/*! \brief The coordinates of the junctions of a partition as a structure of arrays, from which the rows of the
+ *         condensed distance matrix are computed in loops without branches, which the compiler can vectorise.
+ *
+ * \details Two junctions have the same class id, if they connect the same reference sequences with the same
+ *          orientations and have the same sv_class(). Each junction of class 0 gets an own class id. The positions and
+ *          sizes are integers stored as doubles, thus the distances are identical to junction_distance().
+ */
+struct JunctionBatch
+{
+    std::vector<int32_t> class_id{};
+    std::vector<uint8_t> inter_chromosomal{};
+    std::vector<double> mate1_position{};
+    std::vector<double> mate2_position{};
+    std::vector<double> directed_size{}; // absolute value of the directed size of intra-chromosomal junctions
+    std::vector<double> inserted_size{};
+
+    explicit JunctionBatch(std::span<Junction const> const partition)
+    {
+        size_t const partition_size = partition.size();
+        class_id.reserve(partition_size);
+        inter_chromosomal.reserve(partition_size);
+        mate1_position.reserve(partition_size);
+        mate2_position.reserve(partition_size);
+        directed_size.reserve(partition_size);
+        inserted_size.reserve(partition_size);
+
+        std::vector<size_t> class_representatives{}; // the first junction of each class
+        for (size_t i = 0; i < partition_size; ++i)
+        {
+            Junction const & junction = partition[i];
+            int32_t const junction_class = sv_class(junction);
+            auto same_class = [&] (size_t const representative)
+            {
+                Junction const & other = partition[representative];
+                return junction_class != 0 &&
+                       sv_class(other) == junction_class &&
+                       other.get_mate1().seq_name == junction.get_mate1().seq_name &&
+                       other.get_mate1().orientation == junction.get_mate1().orientation &&
+                       other.get_mate2().seq_name == junction.get_mate2().seq_name &&
+                       other.get_mate2().orientation == junction.get_mate2().orientation;
+            };
+            auto const it = std::ranges::find_if(class_representatives, same_class);
+            class_id.push_back(it - class_representatives.begin());
+            if (it == class_representatives.end())
+                class_representatives.push_back(i);
+
+            int32_t const size = junction.get_inserted_sequence().size() +
+                                 junction.get_mate1().position -
+                                 junction.get_mate2().position;
+            inter_chromosomal.push_back(junction_class == 2);
+            mate1_position.push_back(junction.get_mate1().position);
+            mate2_position.push_back(junction.get_mate2().position);
+            // The size is only compared within class -1 and 1, a size of 1 avoids the division by 0 in distance_row().
+            directed_size.push_back((junction_class == -1 || junction_class == 1) ? std::abs(size) : 1);
+            inserted_size.push_back(junction.get_inserted_sequence().size());
+        }
+    }
+
+    /*! \brief Computes the junction_distance() of junction i to all junctions j > i.
+     *
+     * \param[in] i - the index of the junction
+     * \param[out] row - the row of the condensed distance matrix with partition size - i - 1 elements
+     */
+    void distance_row(size_t const i, double * row) const
+    {
+        size_t const partition_size = class_id.size();
+        int32_t const row_class = class_id[i];
+        double const row_position1 = mate1_position[i];
+        // The distance of junctions of different classes is raised to the maximum by std::max instead of a branch,
+        // because the division must not be moved into a branch for the loop to be vectorised.
+        double const max_distance = std::numeric_limits<double>::max();
+        if (inter_chromosomal[i])
+        {
+            double const row_position2 = mate2_position[i];
+            double const row_inserted_size = inserted_size[i];
+            for (size_t j = i + 1; j < partition_size; ++j)
+            {
+                double const distance = std::abs(row_position1 - mate1_position[j]) / 1000.0 +
+                                        std::abs(row_position2 - mate2_position[j]) / 1000.0 +
+                                        std::abs(row_inserted_size - inserted_size[j]) / 1000.0;
+                row[j - i - 1] = std::max((class_id[j] == row_class) ? 0.0 : max_distance, distance);
+            }
+        }
+        else
+        {
+            double const row_size = directed_size[i];
+            for (size_t j = i + 1; j < partition_size; ++j)
+            {
+                double const distance = std::abs(row_position1 - mate1_position[j]) / 1000.0 +
+                                        (std::max(row_size, directed_size[j]) / std::min(row_size, directed_size[j]) -
+                                         1.0);
+                row[j - i - 1] = std::max((class_id[j] == row_class) ? 0.0 : max_distance, distance);
+            }
+        }
+    }
+};
+
+// The maximum partition size, for which the full distance matrix is computed without decomposing the partition. It is
+// also the maximum size of a component, which is not approximated by the sparse average linkage, if it is requested.
+constexpr size_t max_dense_partition_size = 200;
+
+// The sparse average linkage uses the distances of the junctions in the neighbourhood of this multiple of the
+// clustering cutoff.
+constexpr double sparse_radius_factor = 2.0;
+
+// The sparse average linkage starts with micro-clusters of the junctions in a grid cell of this width relative to the
+// clustering cutoff.
+constexpr double micro_cluster_width_factor = 0.125;
+
+/*! \brief The coordinates of a junction, in which the L1 distance of two junctions of the same group is a lower bound
+ *         of their junction_distance().
+ *
+ * \details Intra-chromosomal junctions are grouped by the sign of their directed size and use the coordinates
+ *          (mate1 position / 1000, ln |directed size|), because ln(max/min) <= max/min - 1. Inter-chromosomal junctions
+ *          use (mate1 position / 1000, mate2 position / 1000, inserted size / 1000), which is exact. Junctions of group
+ *          0 (directed size 0) have the maximal distance to all other junctions.
+ */
+struct JunctionCoordinates
+{
+    int32_t group;
+    std::array<double, 3> values;
+};
+
+JunctionCoordinates junction_coordinates(Junction const & junction)
+{
+    double const position1 = junction.get_mate1().position / 1000.0;
+    int32_t const group = sv_class(junction);
+    if (group == 2)
+    {
+        return {group,
+                {position1, junction.get_mate2().position / 1000.0, junction.get_inserted_sequence().size() / 1000.0}};
+    }
+    if (group == 0)
+        return {group, {position1, 0.0, 0.0}};
+    int32_t const directed_size = junction.get_inserted_sequence().size() +
+                                  junction.get_mate1().position -
+                                  junction.get_mate2().position;
+    return {group, {position1, std::log(std::abs(directed_size)), 0.0}};
+}
+
+/*! \brief An upper bound of the junction_distance() of all pairs of junctions, whose coordinates lie in the given
+ *         bounding box.
+ */
+double diameter_bound(int32_t const group, std::array<double, 3> const & min, std::array<double, 3> const & max)
 {
-    assert(partition.size() >= sample_size);
-    std::vector<Junction> subsample{};
-    std::sample(partition.begin(), partition.end(), std::back_inserter(subsample),
-                sample_size, std::mt19937{}); // use default seed for deterministic results
-    return subsample;
+    switch (group)
+    {
+        case -1:
+        case 1:
+            return (max[0] - min[0]) + std::expm1(max[1] - min[1]);
+        case 2:
+            return (max[0] - min[0]) + (max[1] - min[1]) + (max[2] - min[2]);
+        default:
+            return std::numeric_limits<double>::max();
+    }
 }
 
-std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> const & junctions,
-                                                    int32_t const partition_max_distance,
-                                                    double clustering_cutoff)
+/*! \brief A grid over the coordinates of a set of junctions. The cell width is half of the given radius, thus two
+ *         junctions with a distance below the radius lie at most two cells apart in each dimension.
+ */
+class JunctionGrid
 {
-    auto partitions = partition_junctions(junctions, partition_max_distance);
-    std::vector<Cluster> clusters{};
-    // Set the maximum partition size that is still feasible to cluster in reasonable time
-    // A trade-off between reducing runtime and keeping as many junctions as possible has to be made
-    const size_t max_partition_size = 200;
-    for (std::vector<Junction> & partition : partitions)
+private:
+    using cell_key_t = std::array<int64_t, 4>; // group and cell index in each dimension
+
+    struct Cell
     {
-        size_t partition_size = partition.size();
-        if (partition_size < 2)
+        std::vector<size_t> members{};
+        std::array<double, 3> min{};
+        std::array<double, 3> max{};
+    };
+
+    std::map<cell_key_t, Cell> cells{};
+
+public:
+    JunctionGrid(std::vector<JunctionCoordinates> const & coordinates,
+                 std::vector<size_t> const & members,
+                 double const radius)
+    {
+        double const cell_width = radius / 2;
+        for (size_t const member : members)
         {
-            clusters.emplace_back(std::move(partition));
-            continue;
+            JunctionCoordinates const & point = coordinates[member];
+            cell_key_t const key{point.group,
+                                 static_cast<int64_t>(std::floor(point.values[0] / cell_width)),
+                                 static_cast<int64_t>(std::floor(point.values[1] / cell_width)),
+                                 static_cast<int64_t>(std::floor(point.values[2] / cell_width))};
+            auto [it, inserted] = cells.try_emplace(key);
+            Cell & cell = it->second;
+            for (size_t d = 0; d < 3; ++d)
+            {
+                cell.min[d] = inserted ? point.values[d] : std::min(cell.min[d], point.values[d]);
+                cell.max[d] = inserted ? point.values[d] : std::max(cell.max[d], point.values[d]);
+            }
+            cell.members.push_back(member);
         }
-        if (partition_size > max_partition_size)
+    }
+
+    /*! \brief Calls `process_cell(group, members, min, max)` for each cell and `process_cell_pair(members,
+     *         other_members, same_cell)` once for each pair of cells, which may contain junctions with a distance below
+     *         the radius (including each cell with itself).
+     */
+    template <typename process_cell_t, typename process_cell_pair_t>
+    void for_each_cell(process_cell_t && process_cell, process_cell_pair_t && process_cell_pair) const
+    {
+        for (auto const & [key, cell] : cells)
         {
-            if (gVerbose)
+            process_cell(key[0], cell.members, cell.min, cell.max);
+            if (key[0] == 0) // junctions of group 0 are never close to another junction
+                continue;
+            for (int64_t d1 = -2; d1 <= 2; ++d1)
             {
-                seqan3::debug_stream << "A partition exceeds the maximum size ("
-                                    << partition_size
-                                    << ">"
-                                    << max_partition_size
-                                    << ") and has to be subsampled. Representative partition member:\n["
-                                    << partition[0].get_mate1()
-                                    << "] -> ["
-                                    << partition[0].get_mate2()
-                                    << "]\n";
+                for (int64_t d2 = -2; d2 <= 2; ++d2)
+                {
+                    for (int64_t d3 = -2; d3 <= 2; ++d3)
+                    {
+                        cell_key_t const other_key{key[0], key[1] + d1, key[2] + d2, key[3] + d3};
+                        if (other_key < key)
+                            continue; // each pair of cells is visited once
+                        auto const other = cells.find(other_key);
+                        if (other != cells.end())
+                            process_cell_pair(cell.members, other->second.members, other_key == key);
+                    }
+                }
             }
-            partition = subsample_partition(partition, max_partition_size);
-            partition_size = max_partition_size;
         }
-        // Compute condensed distance matrix (upper triangle of the full distance matrix)
-        std::vector<double> distmat ((partition_size * (partition_size - 1)) / 2);
-        size_t k, i, j;
-        for (i = k = 0; i < partition_size; ++i) {
-            for (j = i + 1; j< partition_size; ++j) {
-                // Compute distance between junctions i and j
-                distmat[k] = junction_distance(partition[i], partition[j]);
-                ++k;
+    }
+};
+
+//! \brief A disjoint-set forest with path halving and union by size.
+class UnionFind
+{
+private:
+    std::vector<size_t> parent;
+    std::vector<size_t> set_size;
+
+public:
+    explicit UnionFind(size_t const size) : parent(size), set_size(size, 1)
+    {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    size_t find(size_t element)
+    {
+        while (parent[element] != element)
+        {
+            parent[element] = parent[parent[element]];
+            element = parent[element];
+        }
+        return element;
+    }
+
+    void unite(size_t const a, size_t const b)
+    {
+        size_t root_a = find(a);
+        size_t root_b = find(b);
+        if (root_a == root_b)
+            return;
+        if (set_size[root_a] < set_size[root_b])
+            std::swap(root_a, root_b);
+        parent[root_b] = root_a;
+        set_size[root_a] += set_size[root_b];
+    }
+};
+
+std::vector<size_t> bounded_average_linkage(size_t const size,
+                                            std::vector<double> & distances,
+                                            double const clustering_cutoff)
+{
+    // Index of the pair i < j in the condensed distance matrix.
+    auto pair_index = [size] (size_t const i, size_t const j)
+    {
+        return (i < j) ? i * size - i * (i + 1) / 2 + j - i - 1 : j * size - j * (j + 1) / 2 + i - j - 1;
+    };
+
+    // The average distance of two clusters is smaller than the cutoff only if one of their pairs is, thus the clusters
+    // never span two connected components of the pairs closer than the cutoff and the components are clustered
+    // independently of each other.
+    UnionFind components{size};
+    for (size_t i = 0, k = 0; i < size; ++i)
+    {
+        for (size_t j = i + 1; j < size; ++j, ++k)
+        {
+            if (distances[k] < clustering_cutoff)
+                components.unite(i, j);
+        }
+    }
+    std::vector<std::vector<size_t>> component_members{};
+    {
+        std::vector<size_t> component_of_root(size, size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            size_t & component = component_of_root[components.find(i)];
+            if (component == size)
+            {
+                component = component_members.size();
+                component_members.emplace_back();
             }
+            component_members[component].push_back(i);
         }
+    }
 
-        // Perform hierarchical clustering
-        // `height` is filled with cluster distance for each step
-        // `merge` contains dendrogram
-        std::vector<int> merge (2 * (partition_size - 1));
-        std::vector<double> height (partition_size - 1);
-        hclust_fast(partition_size, distmat.data(), HCLUST_METHOD_AVERAGE, merge.data(), height.data());
+    size_t const npos = size;
+    std::vector<size_t> cluster_sizes(size, 1);
+    std::vector<size_t> merged_into(size, npos);
+    std::vector<size_t> chain{};
+    for (std::vector<size_t> & open : component_members)
+    {
+        // `open` holds the clusters of the component, which may still be merged. A cluster without a neighbour closer
+        // than the cutoff is final, because the average distance to the union of two clusters is at least the smaller
+        // of both distances.
+        auto close = [&open] (size_t const cluster) { open.erase(std::ranges::find(open, cluster)); };
+        while (open.size() > 1)
+        {
+            if (chain.empty())
+                chain.push_back(open.front());
 
-        // Fill labels[i] with cluster label of junction i.
-        // Clustering is stopped at step with cluster distance >= clustering_cutoff
-        std::vector<int> labels (partition_size);
-        cutree_cdist(partition_size, merge.data(), height.data(), clustering_cutoff, labels.data());
+            size_t const a = chain.back();
+            size_t const previous = (chain.size() >= 2) ? chain[chain.size() - 2] : npos;
+            size_t nearest = npos;
+            double nearest_distance = clustering_cutoff;
+            for (size_t const b : open)
+            {
+                if (b == a)
+                    continue;
+                double const distance = distances[pair_index(a, b)];
+                // Ties are resolved in favour of the previous cluster of the chain, thus the chain never runs in a
+                // cycle, and otherwise of the first cluster in `open`.
+                if (distance < nearest_distance || (distance == nearest_distance && nearest != npos && b == previous))
+                {
+                    nearest = b;
+                    nearest_distance = distance;
+                }
+            }
+
+            if (nearest == npos) // the cluster is final
+            {
+                chain.pop_back();
+                close(a);
+            }
+            else if (nearest == previous)
+            {
+                // Reciprocal nearest neighbours are merged into the one with the smaller index, which is the first
+                // element of the merged cluster, thus `open` stays ordered by the first elements of the clusters. The
+                // distances to the merged cluster are updated by the Lance-Williams formula of the average linkage.
+                chain.pop_back();
+                chain.pop_back();
+                auto const [kept, removed] = std::minmax(a, nearest);
+                double const weight_kept = cluster_sizes[kept];
+                double const weight_removed = cluster_sizes[removed];
+                for (size_t const c : open)
+                {
+                    if (c == kept || c == removed)
+                        continue;
+                    double & distance = distances[pair_index(kept, c)];
+                    distance = (weight_kept * distance + weight_removed * distances[pair_index(removed, c)]) /
+                               (weight_kept + weight_removed);
+                }
+                cluster_sizes[kept] += cluster_sizes[removed];
+                merged_into[removed] = kept;
+                close(removed);
+            }
+            else
+            {
+                chain.push_back(nearest);
+            }
+        }
+        chain.clear();
+    }
 
-        std::unordered_map<int, std::vector<Junction>> label_to_junctions{};
+    // Number the clusters in the order of their first element.
+    std::vector<size_t> labels(size, npos);
+    size_t amount_clusters = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        size_t root = i;
+        while (merged_into[root] != npos)
+            root = merged_into[root];
+        if (labels[root] == npos)
+            labels[root] = amount_clusters++;
+        labels[i] = labels[root];
+    }
+    return labels;
+}
+
+/*! \brief Approximate average linkage clustering of a set of junctions via the nearest-neighbour chain algorithm on the
+ *         sparse graph of the junctions in neighbouring cells of a grid with a cell width of sparse_radius_factor / 2
+ *         times the cutoff.
+ *
+ * \param[in] partition - the junctions
+ * \param[in] members - the indices of the junctions to cluster
+ * \param[in] coordinates - the coordinates of the junctions
+ * \param[in] clustering_cutoff - distance cutoff for clustering
+ *
+ * \returns The clusters as lists of junction indices.
+ *
+ * \details The result approximates the average linkage of bounded_average_linkage() in two ways:
+ *          1. The junctions of each cell of a fine grid with a cell width of micro_cluster_width_factor times the
+ *             cutoff form the initial clusters. Their diameter is below 0.4 times the cutoff.
+ *          2. The average distance of two clusters is computed from the sum and the number of their pairs in
+ *             neighbouring cells, which contribute their junction_distance(). Each other pair contributes the radius,
+ *             which is a lower bound of its distance, thus clusters are rather merged than kept apart.
+ *          The average linkage of these pairwise distances is reducible, thus the nearest-neighbour chain algorithm
+ *          merges the same clusters as the greedy algorithm. The links are stored per pair of micro-clusters, thus
+ *          their number is bounded by the number of grid cells and not by the number of junctions in a pile.
+ */
+std::vector<std::vector<size_t>> sparse_average_linkage(std::span<Junction const> const partition,
+                                                        std::vector<size_t> const & members,
+                                                        std::vector<JunctionCoordinates> const & coordinates,
+                                                        double const clustering_cutoff)
+{
+    struct Link
+    {
+        double sum{0};
+        size_t count{0};
+    };
+
+    // The initial micro-clusters, i.e. the junctions of each cell of the fine grid.
+    std::vector<std::vector<size_t>> cluster_members{};
+    std::vector<size_t> cluster_of_junction(partition.size());
+    {
+        double const cell_width = micro_cluster_width_factor * clustering_cutoff;
+        std::map<std::array<int64_t, 4>, size_t> cluster_of_cell{};
+        for (size_t const member : members)
+        {
+            JunctionCoordinates const & point = coordinates[member];
+            std::array<int64_t, 4> const key{point.group,
+                                             static_cast<int64_t>(std::floor(point.values[0] / cell_width)),
+                                             static_cast<int64_t>(std::floor(point.values[1] / cell_width)),
+                                             static_cast<int64_t>(std::floor(point.values[2] / cell_width))};
+            auto const [it, inserted] = cluster_of_cell.try_emplace(key, cluster_members.size());
+            if (inserted)
+                cluster_members.emplace_back();
+            cluster_members[it->second].push_back(member);
+            cluster_of_junction[member] = it->second;
+        }
+    }
+
+    size_t const n = cluster_members.size();
+    std::vector<std::unordered_map<size_t, Link>> links(n);
+    double const radius = sparse_radius_factor * clustering_cutoff;
+    JunctionGrid const grid{coordinates, members, radius};
+    grid.for_each_cell([] (auto &&...) {},
+                       [&] (std::vector<size_t> const & cell, std::vector<size_t> const & other_cell, bool const same)
+    {
+        for (size_t i = 0; i < cell.size(); ++i)
+        {
+            for (size_t j = same ? i + 1 : 0; j < other_cell.size(); ++j)
+            {
+                size_t const a = cluster_of_junction[cell[i]];
+                size_t const b = cluster_of_junction[other_cell[j]];
+                if (a == b)
+                    continue;
+                double const distance = junction_distance(partition[cell[i]], partition[other_cell[j]]);
+                for (Link * const link : {&links[a][b], &links[b][a]})
+                {
+                    link->sum += distance;
+                    ++link->count;
+                }
+            }
+        }
+    });
+
+    std::vector<bool> active(n, true);
+
+    auto average_distance = [&] (size_t const a, size_t const b, Link const & link)
+    {
+        double const pairs = static_cast<double>(cluster_members[a].size()) * cluster_members[b].size();
+        return (link.sum + (pairs - link.count) * radius) / pairs;
+    };
+
+    std::vector<size_t> chain{};
+    size_t next_start = 0;
+    while (true)
+    {
+        if (chain.empty())
+        {
+            while (next_start < n && !active[next_start])
+                ++next_start;
+            if (next_start == n)
+                break;
+            chain.push_back(next_start);
+        }
+
+        size_t const a = chain.back();
+        size_t const previous = (chain.size() >= 2) ? chain[chain.size() - 2] : n;
+        size_t nearest = n;
+        double nearest_distance = clustering_cutoff;
+        for (auto const & [b, link] : links[a])
+        {
+            if (!active[b])
+                continue;
+            double const distance = average_distance(a, b, link);
+            // Ties are resolved in favour of the previous cluster of the chain and then of the smaller index.
+            if (distance < nearest_distance ||
+                (distance == nearest_distance && nearest != n && nearest != previous && (b == previous || b < nearest)))
+            {
+                nearest = b;
+                nearest_distance = distance;
+            }
+        }
+
+        if (nearest == n) // the cluster is final
+        {
+            active[a] = false;
+            chain.pop_back();
+        }
+        else if (nearest == previous)
+        {
+            chain.pop_back();
+            chain.pop_back();
+            // Merge the clusters into `a`.
+            for (auto const & [c, link] : links[nearest])
+            {
+                if (c == a)
+                    continue;
+                Link & merged = links[a][c];
+                merged.sum += link.sum;
+                merged.count += link.count;
+                links[c][a] = merged;
+                links[c].erase(nearest);
+            }
+            links[a].erase(nearest);
+            links[nearest].clear();
+            cluster_members[a].insert(cluster_members[a].end(),
+                                      cluster_members[nearest].begin(),
+                                      cluster_members[nearest].end());
+            cluster_members[nearest].clear();
+            active[nearest] = false;
+        }
+        else
+        {
+            chain.push_back(nearest);
+        }
+    }
+
+    std::erase_if(cluster_members, [] (std::vector<size_t> const & cluster) { return cluster.empty(); });
+    return cluster_members;
+}
+
+/*! \brief Cluster the junctions of a partition by bounded_average_linkage() over the full distance matrix.
+ *
+ * \param[in, out] partition - a partition of at least two junctions, the junctions are moved into the returned
+ *                             clusters
+ * \param[in] clustering_cutoff - distance cutoff for clustering
+ *
+ * \returns Returns the clusters of the partition, each with sorted junctions.
+ */
+std::vector<Cluster> cluster_dense_partition(std::span<Junction> const partition, double clustering_cutoff)
+{
+    size_t const partition_size = partition.size();
+
+    // Compute condensed distance matrix (upper triangle of the full distance matrix)
+    std::vector<double> distmat ((partition_size * (partition_size - 1)) / 2);
+    JunctionBatch const batch{partition};
+    for (size_t i = 0, k = 0; i < partition_size; k += partition_size - i - 1, ++i)
+    {
+        batch.distance_row(i, distmat.data() + k);
+    }
+
+    // Perform hierarchical clustering, which is stopped at the cluster distance clustering_cutoff.
+    std::vector<size_t> const labels = bounded_average_linkage(partition_size, distmat, clustering_cutoff);
+
+    // Add new clusters: junctions with the same label belong to one cluster
+    std::vector<std::vector<Junction>> label_to_junctions(*std::ranges::max_element(labels) + 1);
+    for (size_t i = 0; i < partition_size; ++i)
+    {
+        label_to_junctions[labels[i]].push_back(std::move(partition[i]));
+    }
+
+    std::vector<Cluster> clusters{};
+    clusters.reserve(label_to_junctions.size());
+    for (std::vector<Junction> & junctions : label_to_junctions)
+    {
+        std::sort(junctions.begin(), junctions.end());
+        clusters.emplace_back(std::move(junctions));
+    }
+    return clusters;
+}
+
+/*! \brief Cluster the junctions of a partition, which is too large for the full distance matrix.
+ *
+ * \param[in, out] partition - a partition of junctions, the junctions are moved into the returned clusters
+ * \param[in] clustering_cutoff - distance cutoff for clustering
+ * \param[in] approximate_large_components - cluster large components by sparse_average_linkage()
+ *
+ * \returns Returns the clusters of the partition, each with sorted junctions.
+ *
+ * \details Average linkage never merges two clusters, if all pairs between them have a distance of at least the
+ *          cutoff. Thus, the connected components of the graph of all pairs with a distance below the cutoff are
+ *          clustered independently, which does not change the result. The pairs are found via a grid over the
+ *          junction coordinates, which only compares junctions of neighbouring cells. A component, whose junctions are
+ *          all closer than the cutoff, is a single cluster. The other components are clustered via the full distance
+ *          matrix. Only if approximate_large_components is set, components with more than max_dense_partition_size
+ *          junctions are clustered via sparse_average_linkage() instead, whose memory does not grow quadratically.
+ */
+std::vector<Cluster> cluster_large_partition(std::span<Junction> const partition,
+                                             double clustering_cutoff,
+                                             bool const approximate_large_components)
+{
+    size_t const partition_size = partition.size();
+    std::vector<Cluster> clusters{};
+    if (clustering_cutoff <= 0) // no junctions are merged
+    {
+        for (Junction & junction : partition)
+            clusters.emplace_back(std::vector{std::move(junction)});
+        return clusters;
+    }
+
+    std::vector<JunctionCoordinates> coordinates{};
+    coordinates.reserve(partition_size);
+    for (Junction const & junction : partition)
+        coordinates.push_back(junction_coordinates(junction));
+
+    std::vector<size_t> all_members(partition_size);
+    std::iota(all_members.begin(), all_members.end(), 0);
+
+    // Find the connected components. The junctions of a cell with a diameter below the cutoff are connected without
+    // computing their distances and pairs of cells that are already connected are skipped.
+    UnionFind components{partition_size};
+    JunctionGrid const grid{coordinates, all_members, clustering_cutoff};
+    std::vector<bool> connected_cell(partition_size, false); // indexed by the first member of a cell
+    grid.for_each_cell([&] (int32_t const group,
+                            std::vector<size_t> const & cell,
+                            std::array<double, 3> const & min,
+                            std::array<double, 3> const & max)
+    {
+        if (diameter_bound(group, min, max) < clustering_cutoff)
+        {
+            for (size_t const member : cell)
+                components.unite(cell.front(), member);
+            connected_cell[cell.front()] = true;
+        }
+    },
+                       [&] (std::vector<size_t> const & cell, std::vector<size_t> const & other_cell, bool const same)
+    {
+        if (same && connected_cell[cell.front()])
+            return;
+        if (connected_cell[cell.front()] && connected_cell[other_cell.front()] &&
+            components.find(cell.front()) == components.find(other_cell.front()))
+        {
+            return;
+        }
+        for (size_t i = 0; i < cell.size(); ++i)
+        {
+            for (size_t j = same ? i + 1 : 0; j < other_cell.size(); ++j)
+            {
+                if (components.find(cell[i]) != components.find(other_cell[j]) &&
+                    junction_distance(partition[cell[i]], partition[other_cell[j]]) < clustering_cutoff)
+                {
+                    components.unite(cell[i], other_cell[j]);
+                }
+            }
+        }
+    });
+
+    // Reorder the partition in place, such that the junctions of each component are contiguous and keep their order.
+    // order[k] is the current index of the junction, which is moved to index k.
+    std::vector<size_t> component_begin{}; // indexed by the component, which are numbered by their first junction
+    std::vector<size_t> component_of_root(partition_size, partition_size);
+    std::vector<size_t> component_of_junction(partition_size);
+    for (size_t i = 0; i < partition_size; ++i)
+    {
+        size_t & component = component_of_root[components.find(i)];
+        if (component == partition_size)
+        {
+            component = component_begin.size();
+            component_begin.push_back(0);
+        }
+        component_of_junction[i] = component;
+        ++component_begin[component];
+    }
+    std::exclusive_scan(component_begin.begin(), component_begin.end(), component_begin.begin(), size_t{0});
+    component_begin.push_back(partition_size);
+
+    std::vector<size_t> order(partition_size);
+    {
+        std::vector<size_t> next_index{component_begin.begin(), component_begin.end() - 1};
         for (size_t i = 0; i < partition_size; ++i)
+            order[next_index[component_of_junction[i]]++] = i;
+    }
+    for (size_t k = 0; k < partition_size; ++k)
+    {
+        size_t current = k;
+        while (order[current] != k)
+        {
+            size_t const next = order[current];
+            std::swap(partition[current], partition[next]);
+            std::swap(coordinates[current], coordinates[next]);
+            order[current] = current;
+            current = next;
+        }
+        order[current] = current;
+    }
+
+    for (size_t component = 0; component + 1 < component_begin.size(); ++component)
+    {
+        size_t const begin = component_begin[component];
+        size_t const end = component_begin[component + 1];
+        std::array<double, 3> min = coordinates[begin].values;
+        std::array<double, 3> max = min;
+        for (size_t member = begin; member < end; ++member)
         {
-            if (label_to_junctions.find(labels[i]) != label_to_junctions.end())
+            for (size_t d = 0; d < 3; ++d)
             {
-                label_to_junctions[labels[i]].push_back(std::move(partition[i]));
+                min[d] = std::min(min[d], coordinates[member].values[d]);
+                max[d] = std::max(max[d], coordinates[member].values[d]);
             }
-            else{
-                label_to_junctions.emplace(labels[i], std::vector{std::move(partition[i])});
+        }
+
+        std::vector<std::vector<size_t>> component_clusters{};
+        if (end - begin == 1 || diameter_bound(coordinates[begin].group, min, max) < clustering_cutoff)
+        {
+            component_clusters.emplace_back(end - begin);
+            std::iota(component_clusters.back().begin(), component_clusters.back().end(), begin);
+        }
+        else if (end - begin <= max_dense_partition_size || !approximate_large_components)
+        {
+            for (Cluster & cluster : cluster_dense_partition(partition.subspan(begin, end - begin), clustering_cutoff))
+                clusters.push_back(std::move(cluster));
+            continue;
+        }
+        else
+        {
+            std::vector<size_t> members(end - begin);
+            std::iota(members.begin(), members.end(), begin);
+            component_clusters = sparse_average_linkage(partition, members, coordinates, clustering_cutoff);
+        }
+
+        for (std::vector<size_t> const & cluster_members : component_clusters)
+        {
+            std::vector<Junction> cluster_junctions{};
+            cluster_junctions.reserve(cluster_members.size());
+            for (size_t const member : cluster_members)
+                cluster_junctions.push_back(std::move(partition[member]));
+            std::sort(cluster_junctions.begin(), cluster_junctions.end());
+            clusters.emplace_back(std::move(cluster_junctions));
+        }
+    }
+    return clusters;
+}
+
+/*! \brief Cluster the junctions of a single partition by an hierarchical clustering method.
+ *
+ * \param[in, out] partition - a partition of junctions, the junctions are moved into the returned clusters
+ * \param[in] clustering_cutoff - distance cutoff for clustering
+ * \param[in] approximate_large_components - cluster large components by sparse_average_linkage()
+ *
+ * \returns Returns the clusters of the partition, each with sorted junctions.
+ */
+std::vector<Cluster> cluster_partition(std::span<Junction> const partition,
+                                       double clustering_cutoff,
+                                       bool const approximate_large_components)
+{
+    if (partition.size() < 2)
+    {
+        return {Cluster{std::vector(std::make_move_iterator(partition.begin()),
+                                    std::make_move_iterator(partition.end()))}};
+    }
+    if (partition.size() > max_dense_partition_size)
+    {
+        return cluster_large_partition(partition, clustering_cutoff, approximate_large_components);
+    }
+    return cluster_dense_partition(partition, clustering_cutoff);
+}
+
+std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> junctions,
+                                                    int32_t const partition_max_distance,
+                                                    double clustering_cutoff,
+                                                    size_t const threads,
+                                                    bool const approximate_large_components)
+{
+    // The partitions are contiguous ranges of `junctions`. Junctions of different classes have the maximal distance to
+    // each other, thus they are never clustered together and are not compared in the same distance matrix.
+    std::vector<std::span<Junction>> partitions{};
+    for (std::span<Junction> const position_partition : partition_junctions(junctions, partition_max_distance))
+    {
+        for (std::span<Junction> const partition : split_partition_by_sv_class(position_partition))
+            partitions.push_back(partition);
+    }
+    if (gVerbose)
+    {
+        for (std::span<Junction> const partition : partitions)
+        {
+            if (partition.size() > max_dense_partition_size)
+            {
+                seqan3::debug_stream << "A partition exceeds the maximum size for the distance matrix ("
+                                     << partition.size()
+                                     << ">"
+                                     << max_dense_partition_size
+                                     << ") and is decomposed. Representative partition member:\n["
+                                     << partition[0].get_mate1()
+                                     << "] -> ["
+                                     << partition[0].get_mate2()
+                                     << "]\n";
             }
         }
+    }
+
+    // The partitions are independent of each other and are clustered concurrently. The clusters are stored per
+    // partition, such that the result does not depend on the number of threads.
+    std::vector<std::vector<Cluster>> clusters_per_partition(partitions.size());
 
-        // Add new clusters: junctions with the same label belong to one cluster
-        for (auto & [lab, jun] : label_to_junctions )
+    // Hand out the largest partitions first, because a few huge partitions dominate the runtime.
+    std::vector<size_t> partition_order(partitions.size());
+    std::iota(partition_order.begin(), partition_order.end(), 0);
+    std::stable_sort(partition_order.begin(), partition_order.end(), [&partitions] (size_t const a, size_t const b) {
+        return partitions[a].size() > partitions[b].size();
+    });
+
+    std::atomic<size_t> next_partition{0};
+    auto cluster_partitions = [&] ()
+    {
+        for (size_t i = next_partition++; i < partition_order.size(); i = next_partition++)
         {
-            (void) lab;
-            std::sort(jun.begin(), jun.end());
-            clusters.emplace_back(jun);
+            size_t const partition_index = partition_order[i];
+            clusters_per_partition[partition_index] = cluster_partition(partitions[partition_index],
+                                                                        clustering_cutoff,
+                                                                        approximate_large_components);
         }
+    };
+
+    std::vector<std::future<void>> workers{};
+    for (size_t t = 1; t < std::min<size_t>(threads, partitions.size()); ++t)
+        workers.push_back(std::async(std::launch::async, cluster_partitions));
+    cluster_partitions();
+    for (std::future<void> & worker : workers)
+        worker.get();
+
+    std::vector<Cluster> clusters{};
+    for (std::vector<Cluster> & partition_clusters : clusters_per_partition)
+    {
+        clusters.insert(clusters.end(),
+                        std::make_move_iterator(partition_clusters.begin()),
+                        std::make_move_iterator(partition_clusters.end()));
     }
     std::sort(clusters.begin(), clusters.end());
     return clusters;
@@ -0,0 +1,106 @@
+#include "modules/clustering/self_balancing_binary_tree_method.hpp"
+
+#include <algorithm>                                                // for std::max, std::min and std::sort
+#include <cmath>                                                    // for std::abs and std::round
+#include <limits>                                                   // for std::numeric_limits
+#include <ranges>                                                   // for std::views::values
+
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for sv_class
+
+double SelfBalancingBinaryTreeClusterer::centroid_distance(Junction const & junction,
+                                                           Centroid const & centroid,
+                                                           int32_t const junction_class)
+{
+    // The same terms as in junction_distance(), computed with the average coordinates of the centroid.
+    double const amount = centroid.members.size();
+    double const position_distance1 = std::abs(junction.get_mate1().position -
+                                               centroid.sum_mate1_positions / amount) / 1000.0;
+    if (junction_class == 2)
+    {
+        double const position_distance2 = std::abs(junction.get_mate2().position -
+                                                   centroid.sum_mate2_positions / amount) / 1000.0;
+        double const size_distance = std::abs(static_cast<double>(junction.get_inserted_sequence().size()) -
+                                              centroid.sum_inserted_sizes / amount) / 1000.0;
+        return position_distance1 + position_distance2 + size_distance;
+    }
+
+    double const junction_size = std::abs(static_cast<int32_t>(junction.get_inserted_sequence().size() +
+                                                               junction.get_mate1().position -
+                                                               junction.get_mate2().position));
+    double const centroid_size = std::abs(centroid.sum_inserted_sizes +
+                                          centroid.sum_mate1_positions -
+                                          centroid.sum_mate2_positions) / amount;
+    if (centroid_size == 0)
+        return std::numeric_limits<double>::max();
+    return position_distance1 + (std::max(junction_size, centroid_size) / std::min(junction_size, centroid_size) - 1.0);
+}
+
+void SelfBalancingBinaryTreeClusterer::insert(Junction && junction)
+{
+    Breakend const & mate1 = junction.get_mate1();
+    Breakend const & mate2 = junction.get_mate2();
+    int32_t const junction_class = sv_class(junction);
+
+    // Junctions of class 0 have the maximal distance to all other junctions.
+    auto best = centroids.end();
+    if (junction_class != 0)
+    {
+        double best_distance = clustering_cutoff;
+        auto it = centroids.lower_bound({mate1.seq_name, mate1.orientation, mate2.seq_name, mate2.orientation,
+                                         junction_class, mate1.position - partition_max_distance});
+        auto const last = centroids.upper_bound({mate1.seq_name, mate1.orientation, mate2.seq_name, mate2.orientation,
+                                                 junction_class, mate1.position + partition_max_distance});
+        for (; it != last; ++it)
+        {
+            double const distance = centroid_distance(junction, it->second, junction_class);
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best = it;
+            }
+        }
+    }
+
+    Centroid centroid{};
+    if (best != centroids.end())
+    {
+        // The key of the centroid changes with its average position, thus its node is extracted and reinserted.
+        auto node = centroids.extract(best);
+        centroid = std::move(node.mapped());
+    }
+    centroid.sum_mate1_positions += mate1.position;
+    centroid.sum_mate2_positions += mate2.position;
+    centroid.sum_inserted_sizes += junction.get_inserted_sequence().size();
+    int32_t const average_position = std::round(static_cast<double>(centroid.sum_mate1_positions) /
+                                                (centroid.members.size() + 1));
+    centroid_key_t key{mate1.seq_name, mate1.orientation, mate2.seq_name, mate2.orientation,
+                       junction_class, average_position};
+    centroid.members.push_back(std::move(junction));
+    centroids.emplace(std::move(key), std::move(centroid));
+}
+
+std::vector<Cluster> SelfBalancingBinaryTreeClusterer::extract_clusters()
+{
+    std::vector<Cluster> clusters{};
+    clusters.reserve(centroids.size());
+    for (Centroid & centroid : centroids | std::views::values)
+    {
+        std::sort(centroid.members.begin(), centroid.members.end());
+        clusters.emplace_back(std::move(centroid.members));
+    }
+    centroids.clear();
+    std::sort(clusters.begin(), clusters.end());
+    return clusters;
+}
+
+std::vector<Cluster> self_balancing_binary_tree_method(std::vector<Junction> junctions,
+                                                       int32_t const partition_max_distance,
+                                                       double const clustering_cutoff)
+{
+    SelfBalancingBinaryTreeClusterer clusterer{partition_max_distance, clustering_cutoff};
+    for (Junction & junction : junctions)
+    {
+        clusterer.insert(std::move(junction));
+    }
+    return clusterer.extract_clusters();
+}
@@ -10,19 +10,28 @@
 using seqan3::operator""_cigar_operation;
 using seqan3::operator""_dna5;
 
+template <typename sequence_t>
 void analyze_cigar(std::string const & read_name,
                    std::string const & chromosome,
                    int32_t const query_start_pos,
-                   std::vector<seqan3::cigar> & cigar_string,
-                   seqan3::dna5_vector const & query_sequence,
+                   std::vector<seqan3::cigar> const & cigar_string,
+                   sequence_t const & query_sequence,
                    std::vector<Junction> & junctions,
                    int32_t const min_length)
 {
     // Step through CIGAR string and store current position in reference and read
     int32_t pos_ref = query_start_pos;
     int32_t pos_read = 0;
+    // The junctions of the read share its name, which is copied when the first junction is found.
+    std::shared_ptr<std::string const> shared_read_name{};
+    auto junction_read_name = [&] ()
+    {
+        if (!shared_read_name)
+            shared_read_name = std::make_shared<std::string const>(read_name);
+        return shared_read_name;
+    };
 
-    for (seqan3::cigar & pair : cigar_string)
+    for (seqan3::cigar const & pair : cigar_string)
     {
         using seqan3::get;
         int32_t length = get<0>(pair);
@@ -38,12 +47,12 @@ void analyze_cigar(std::string const & read_name,
             if (length >= min_length)
             {
                 // Insertions cause one junction from the insertion location to the next base
-                auto inserted_bases = query_sequence | seqan3::views::slice(pos_read, pos_read + length);
+                auto inserted_bases = query_slice(query_sequence, pos_read, pos_read + length);
                 Junction new_junction{Breakend{chromosome, pos_ref - 1, strand::forward},
                                       Breakend{chromosome, pos_ref, strand::forward},
                                       inserted_bases,
                                       tandem_dup_count,
-                                      read_name};
+                                      junction_read_name()};
                 if (gVerbose)
                     seqan3::debug_stream << "INS: " << new_junction << "\n";
                 junctions.push_back(std::move(new_junction));
@@ -59,7 +68,7 @@ void analyze_cigar(std::string const & read_name,
                                       Breakend{chromosome, pos_ref + length, strand::forward},
                                       ""_dna5,
                                       tandem_dup_count,
-                                      read_name};
+                                      junction_read_name()};
                 if (gVerbose)
                     seqan3::debug_stream << "DEL: " << new_junction << "\n";
                 junctions.push_back(std::move(new_junction));
@@ -77,3 +86,19 @@ void analyze_cigar(std::string const & read_name,
 
     }
 }
+
+template void analyze_cigar<seqan3::dna5_vector>(std::string const & read_name,
+                                                 std::string const & chromosome,
+                                                 int32_t const query_start_pos,
+                                                 std::vector<seqan3::cigar> const & cigar_string,
+                                                 seqan3::dna5_vector const & query_sequence,
+                                                 std::vector<Junction> & junctions,
+                                                 int32_t const min_length);
+
+template void analyze_cigar<query_sequence_t>(std::string const & read_name,
+                                              std::string const & chromosome,
+                                              int32_t const query_start_pos,
+                                              std::vector<seqan3::cigar> const & cigar_string,
+                                              query_sequence_t const & query_sequence,
+                                              std::vector<Junction> & junctions,
+                                              int32_t const min_length);
@@ -1,6 +1,12 @@
 #include "modules/sv_detection_methods/analyze_split_read_method.hpp"
 
-#include <numeric>
+#include <algorithm>     // for std::ranges::count_if
+#include <array>         // for std::array
+#include <cctype>        // for std::isdigit
+#include <charconv>      // for std::from_chars
+#include <memory>        // for std::make_shared and std::shared_ptr
+#include <numeric>       // for std::gcd
+#include <string_view>   // for std::string_view
 
 #include <seqan3/core/debug_stream.hpp>
 
@@ -18,47 +24,113 @@ void split_string(std::string const & str, Container & cont, char const delim)
     }
 }
 
-void retrieve_aligned_segments(std::string const & sa_string, std::vector<AlignedSegment> & aligned_segments)
+template void split_string<std::vector<std::string>>(std::string const & str,
+                                                     std::vector<std::string> & cont,
+                                                     char const delim);
+
+/*! \brief Calls `callback` with a view on each token of a string separated by `delim`. Like split_string(), a trailing
+ *         delimiter does not produce an empty token.
+ */
+template <typename callback_t>
+void for_each_token(std::string_view str, char const delim, callback_t && callback)
+{
+    while (!str.empty())
+    {
+        size_t const token_end = str.find(delim);
+        callback(str.substr(0, token_end));
+        if (token_end == std::string_view::npos)
+            break;
+        str.remove_prefix(token_end + 1);
+    }
+}
+
+//! \brief Parses a whole string as integer, returns false if it contains anything else.
+bool parse_number(std::string_view const str, int32_t & number)
 {
-    std::vector<std::string> sa_tags{};
-    split_string(sa_string, sa_tags, ';');
-    for (std::string sa_tag : sa_tags)
+    auto const [end, error_code] = std::from_chars(str.data(), str.data() + str.size(), number);
+    return error_code == std::errc{} && end == str.data() + str.size() && !str.empty();
+}
+
+//! \brief Parses a CIGAR string like "10S20M5D30M" into `cigar_vector`, returns false if it is malformed.
+bool parse_cigar_string(std::string_view str, std::vector<seqan3::cigar> & cigar_vector)
+{
+    cigar_vector.clear();
+    // Each operation is a single non-digit character.
+    cigar_vector.reserve(std::ranges::count_if(str, [] (unsigned char const c) { return !std::isdigit(c); }));
+    while (!str.empty())
     {
-        std::vector<std::string> fields {};
-        split_string(sa_tag, fields, ',');
-        if (fields.size() == 6)
+        uint32_t length{};
+        auto const [operation_pos, error_code] = std::from_chars(str.data(), str.data() + str.size(), length);
+        if (error_code != std::errc{} || operation_pos == str.data() + str.size() ||
+            !seqan3::char_is_valid_for<seqan3::cigar::operation>(*operation_pos))
+            return false;
+
+        seqan3::cigar::operation operation{};
+        operation.assign_char(*operation_pos);
+        cigar_vector.push_back({length, operation});
+        str.remove_prefix(operation_pos - str.data() + 1);
+    }
+    return !cigar_vector.empty();
+}
+
+void retrieve_aligned_segments(std::string_view const sa_string, std::vector<AlignedSegment> & aligned_segments)
+{
+    // The SA tag is parsed in a single pass over views into the tag. The only allocation per segment is its CIGAR
+    // vector, because short reference names like "chr21" fit into the small string buffer of std::string.
+    // The segments are constructed in place, which computes their coordinates once.
+    for_each_token(sa_string, ';', [&aligned_segments] (std::string_view const sa_tag)
+    {
+        std::array<std::string_view, 6> fields{};
+        size_t field_count = 0;
+        for_each_token(sa_tag, ',', [&fields, &field_count] (std::string_view const field)
         {
-            // As the chromosome names can differ between "1" and "chr1", we would distinguish same SVs from different
-            // input files if the chromosome naming is different. Thus we add the "chr" prefix.
-            std::string const ref_name = (fields[0].starts_with("chr") ? fields[0] : ("chr" + fields[0]));
-            // Decrement by 1 because position in SA tag is stored as string and 1-based unlike other coordinates
-            int32_t pos = std::stoi(fields[1]) - 1;
-            strand orientation;
-            if (fields[2] == "+")
-            {
-                orientation = strand::forward;
-            }
-            else if (fields[2] == "-")
-            {
-                orientation = strand::reverse;
-            }
-            else
-            {
-                continue;
-            }
-            std::string cigar_field = fields[3];
-            std::vector<seqan3::cigar> cigar_vector = std::get<0>(seqan3::detail::parse_cigar(cigar_field));
-            int32_t mapq = std::stoi(fields[4]);
-            aligned_segments.push_back(AlignedSegment{orientation, ref_name, pos, mapq, cigar_vector});
+            if (field_count < fields.size())
+                fields[field_count] = field;
+            ++field_count;
+        });
+        if (field_count != fields.size())
+        {
+            seqan3::debug_stream << "Your SA tag has a wrong format (wrong amount of parameters): " << sa_tag << '\n';
+            return;
+        }
+
+        strand orientation;
+        if (fields[2] == "+")
+        {
+            orientation = strand::forward;
+        }
+        else if (fields[2] == "-")
+        {
+            orientation = strand::reverse;
         }
         else
         {
-            seqan3::debug_stream << "Your SA tag has a wrong format (wrong amount of parameters): " << sa_tag << '\n';
+            return;
         }
-    }
+
+        // As the chromosome names can differ between "1" and "chr1", we would distinguish same SVs from different
+        // input files if the chromosome naming is different. Thus we add the "chr" prefix.
+        std::string ref_name{fields[0].starts_with("chr") ? "" : "chr"};
+        ref_name += fields[0];
+        int32_t pos{};
+        int32_t mapq{};
+        std::vector<seqan3::cigar> cigar_vector{};
+        if (!parse_number(fields[1], pos) ||
+            !parse_number(fields[4], mapq) ||
+            !parse_cigar_string(fields[3], cigar_vector))
+        {
+            seqan3::debug_stream << "Your SA tag has a wrong format (invalid number or CIGAR string): " << sa_tag
+                                 << '\n';
+            return;
+        }
+        // Decrement by 1 because position in SA tag is stored as string and 1-based unlike other coordinates
+        aligned_segments.emplace_back(orientation, std::move(ref_name), pos - 1, mapq, std::move(cigar_vector));
+    });
 }
 
-std::pair<int32_t, int32_t> get_mate_positions(AlignedSegment current, AlignedSegment next, int32_t distance_on_read)
+std::pair<int32_t, int32_t> get_mate_positions(AlignedSegment const & current,
+                                               AlignedSegment const & next,
+                                               int32_t const distance_on_read)
 {
     int32_t mate1_pos;
     if (current.orientation == strand::forward)
@@ -87,9 +159,10 @@ std::pair<int32_t, int32_t> get_mate_positions(AlignedSegment current, AlignedSe
     return std::pair(mate1_pos, mate2_pos);
 }
 
+template <typename sequence_t>
 void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segments,
                               std::vector<Junction> & junctions,
-                              seqan3::dna5_vector const & query_sequence,
+                              sequence_t const & query_sequence,
                               std::string const & read_name,
                               int32_t const min_length,
                               int32_t const max_overlap)
@@ -98,11 +171,19 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
     size_t tandem_dup_length_on_read{0};
     size_t last_tandem_dup_len{0};
     Breakend inversion_mate1{};
+    // The junctions of the read share its name, which is copied when the first junction is found.
+    std::shared_ptr<std::string const> shared_read_name{};
+    auto junction_read_name = [&] ()
+    {
+        if (!shared_read_name)
+            shared_read_name = std::make_shared<std::string const>(read_name);
+        return shared_read_name;
+    };
 
     for (size_t i = 1; i < aligned_segments.size(); i++)
     {
-        AlignedSegment current = aligned_segments[i-1];
-        AlignedSegment next = aligned_segments[i];
+        AlignedSegment const & current = aligned_segments[i-1];
+        AlignedSegment const & next = aligned_segments[i];
         int32_t distance_on_read = next.get_query_start() - current.get_query_end();
         // Check that the overlap between two consecutive alignment segments
         // of the read is lower than the given threshold
@@ -131,8 +212,9 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                     //      |-mate1-|        |-mate2-|
                     if (current.orientation != next.orientation)
                     {
-                        auto inverted_bases = query_sequence | seqan3::views::slice(current.get_query_start(),
-                                                                                    next.get_query_start());
+                        auto inverted_bases = query_slice(query_sequence,
+                                                          current.get_query_start(),
+                                                          next.get_query_start());
 
                         if (current.orientation == strand::forward) // && next.orientation == strand::reverse
                         { // first breakpoint
@@ -140,7 +222,11 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                         }
                         else
                         { // second breakpoint
-                            junctions.emplace_back(inversion_mate1, mate2, inverted_bases, tandem_dup_count, read_name);
+                            junctions.emplace_back(inversion_mate1,
+                                                   mate2,
+                                                   inverted_bases,
+                                                   tandem_dup_count,
+                                                   junction_read_name());
                             if (gVerbose)
                                 seqan3::debug_stream << "INV: " << junctions.back() << "\n"
                                                      << "Inverted bases: " << inverted_bases << "\n";
@@ -153,9 +239,10 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                         amount_tandem_dup_segments = 0;
                         tandem_dup_length_on_read = 0;
                         last_tandem_dup_len = 0;
-                        auto inserted_bases = query_sequence | seqan3::views::slice(current.get_query_end(),
-                                                                                    next.get_query_start());
-                        junctions.emplace_back(mate1, mate2, inserted_bases, tandem_dup_count, read_name);
+                        auto inserted_bases = query_slice(query_sequence,
+                                                          current.get_query_end(),
+                                                          next.get_query_start());
+                        junctions.emplace_back(mate1, mate2, inserted_bases, tandem_dup_count, junction_read_name());
                         if (gVerbose)
                             seqan3::debug_stream << "INS: " << junctions.back() << "\n"
                                                  << "Inserted bases: " << inserted_bases << "\n";
@@ -186,14 +273,19 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                             //                         ||||||||||||||||||||||
                             // next_but_one_segment    ----------------------
                             single_dup_len = std::gcd(last_tandem_dup_len, std::abs(distance_on_ref));
-                            auto single_duplication = query_sequence | seqan3::views::slice(current.get_query_end(),
-                                                                                            current.get_query_end() + single_dup_len);
+                            auto single_duplication = query_slice(query_sequence,
+                                                                  current.get_query_end(),
+                                                                  current.get_query_end() + single_dup_len);
 
                             if (amount_tandem_dup_segments == 0)
                             {
                                 tandem_dup_length_on_read += std::abs(distance_on_ref);
                                 tandem_dup_count = tandem_dup_length_on_read / single_dup_len;
-                                junctions.emplace_back(mate2, mate1, single_duplication, tandem_dup_count, read_name);
+                                junctions.emplace_back(mate2,
+                                                       mate1,
+                                                       single_duplication,
+                                                       tandem_dup_count,
+                                                       junction_read_name());
                             }
                             else
                             {
@@ -202,7 +294,11 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                                 mate2 = Breakend{next.ref_name, current.get_reference_start(), next.orientation};
                                 tandem_dup_count = tandem_dup_length_on_read / single_dup_len;
                                 // Replace last element
-                                junctions.back() = Junction{mate2, mate1, single_duplication, tandem_dup_count, read_name};
+                                junctions.back() = Junction{mate2,
+                                                            mate1,
+                                                            single_duplication,
+                                                            tandem_dup_count,
+                                                            junction_read_name()};
                             }
                             ++amount_tandem_dup_segments;
                             last_tandem_dup_len = std::abs(distance_on_ref);
@@ -222,7 +318,7 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                             amount_tandem_dup_segments = 0;
                             tandem_dup_length_on_read = 0;
                             last_tandem_dup_len = 0;
-                            junctions.emplace_back(mate1, mate2, ""_dna5, tandem_dup_count, read_name);
+                            junctions.emplace_back(mate1, mate2, ""_dna5, tandem_dup_count, junction_read_name());
                             if (gVerbose)
                                 seqan3::debug_stream << "BND: " << junctions.back() << "\n";
                         }
@@ -235,7 +331,7 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                     tandem_dup_length_on_read = 0;
                     last_tandem_dup_len = 0;
 
-                    junctions.emplace_back(mate1, mate2, ""_dna5, tandem_dup_count, read_name);
+                    junctions.emplace_back(mate1, mate2, ""_dna5, tandem_dup_count, junction_read_name());
                     if (gVerbose)
                         seqan3::debug_stream << "BND: " << junctions.back() << "\n";
                 }
@@ -244,18 +340,21 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
     }
 }
 
+template <typename sequence_t>
 void analyze_sa_tag(std::string const & query_name,
                     seqan3::sam_flag const & flag,
                     std::string const & ref_name,
                     int32_t const pos,
                     uint8_t const mapq,
                     std::vector<seqan3::cigar> const & cigar,
-                    seqan3::dna5_vector const & seq,
+                    sequence_t const & seq,
                     std::string const & sa_tag,
                     cmd_arguments const & args,
                     std::vector<Junction> & junctions)
 {
-    std::vector<AlignedSegment> aligned_segments{};
+    // The buffer keeps its capacity between the alignments analysed by a thread.
+    thread_local std::vector<AlignedSegment> aligned_segments{};
+    aligned_segments.clear();
     strand strand = (hasFlagReverseComplement(flag) ? strand::reverse : strand::forward);
     aligned_segments.push_back(AlignedSegment{strand, ref_name, pos, mapq, cigar});
     retrieve_aligned_segments(sa_tag, aligned_segments);
@@ -263,3 +362,39 @@ void analyze_sa_tag(std::string const & query_name,
     std::sort(aligned_segments.begin(), aligned_segments.end());
     analyze_aligned_segments(aligned_segments, junctions, seq, query_name, args.min_var_length, args.max_overlap);
 }
+
+template void analyze_aligned_segments<seqan3::dna5_vector>(std::vector<AlignedSegment> const & aligned_segments,
+                                                            std::vector<Junction> & junctions,
+                                                            seqan3::dna5_vector const & query_sequence,
+                                                            std::string const & read_name,
+                                                            int32_t const min_length,
+                                                            int32_t const max_overlap);
+
+template void analyze_aligned_segments<query_sequence_t>(std::vector<AlignedSegment> const & aligned_segments,
+                                                         std::vector<Junction> & junctions,
+                                                         query_sequence_t const & query_sequence,
+                                                         std::string const & read_name,
+                                                         int32_t const min_length,
+                                                         int32_t const max_overlap);
+
+template void analyze_sa_tag<seqan3::dna5_vector>(std::string const & query_name,
+                                                  seqan3::sam_flag const & flag,
+                                                  std::string const & ref_name,
+                                                  int32_t const pos,
+                                                  uint8_t const mapq,
+                                                  std::vector<seqan3::cigar> const & cigar,
+                                                  seqan3::dna5_vector const & seq,
+                                                  std::string const & sa_tag,
+                                                  cmd_arguments const & args,
+                                                  std::vector<Junction> & junctions);
+
+template void analyze_sa_tag<query_sequence_t>(std::string const & query_name,
+                                               seqan3::sam_flag const & flag,
+                                               std::string const & ref_name,
+                                               int32_t const pos,
+                                               uint8_t const mapq,
+                                               std::vector<seqan3::cigar> const & cigar,
+                                               query_sequence_t const & seq,
+                                               std::string const & sa_tag,
+                                               cmd_arguments const & args,
+                                               std::vector<Junction> & junctions);
@@ -2,124 +2,58 @@
 
 #include <seqan3/alphabet/cigar/cigar.hpp>
 
-int32_t AlignedSegment::get_reference_start() const
-{
-    return pos;
-}
-
-int32_t AlignedSegment::get_reference_end() const
+AlignedSegment::AlignedSegment(strand the_orientation,
+                               std::string the_ref_name,
+                               int32_t the_pos,
+                               int32_t the_mapq,
+                               std::vector<seqan3::cigar> the_cig) : orientation{the_orientation},
+                                                                    ref_name{std::move(the_ref_name)},
+                                                                    mapq{the_mapq},
+                                                                    pos{the_pos},
+                                                                    cig{std::move(the_cig)}
 {
     int32_t current_pos = pos;
+    // The soft clips since the last operation that aligns a base of the read (M, =, X or I).
+    int32_t soft_clip = 0;
+    bool aligned_base_found = false;
     for (auto [element_length, element_operation] : cig)
     {
         switch(element_operation.to_char())
         {
             case 'M':
-            case 'D':
-            case 'N':
             case 'X':
             case '=':
                 current_pos += element_length;
-                break;
-            case 'I':
-            case 'S':
-            case 'H':
-            case 'P': // do nothing
-                break;
-            // default: all other characters will be mapped to M
-        }
-    }
-    // Decrement by 1 to jump back to the last aligned base
-    return current_pos - 1;
-}
-
-int32_t AlignedSegment::get_left_soft_clip() const
-{
-    int32_t left_soft_clip = 0;
-    for (auto [element_length, element_operation] : cig)
-    {
-        if (element_operation.to_char() == 'S')
-        {
-            left_soft_clip += element_length;
-        }
-        else if (element_operation.to_char() == 'M' ||
-                 element_operation.to_char() == '=' ||
-                 element_operation.to_char() == 'X' ||
-                 element_operation.to_char() == 'I')
-        {
-            break;
-        }
-    }
-    return left_soft_clip;
-}
-
-int32_t AlignedSegment::get_right_soft_clip() const
-{
-    int32_t right_soft_clip = 0;
-    for (auto [element_length, element_operation] : std::views::reverse(cig))
-    {
-        if (element_operation.to_char() == 'S')
-        {
-            right_soft_clip += element_length;
-        }
-        else if (element_operation.to_char() == 'M' ||
-                 element_operation.to_char() == '=' ||
-                 element_operation.to_char() == 'X' ||
-                 element_operation.to_char() == 'I')
-        {
-            break;
-        }
-    }
-    return right_soft_clip;
-}
-
-int32_t AlignedSegment::get_query_start() const
-{
-    if (orientation == strand::forward)
-    {
-        return get_left_soft_clip();
-    }
-    else
-    {
-        return get_right_soft_clip();
-    }
-}
-
-int32_t AlignedSegment::get_query_length() const
-{
-    int32_t current_length = 0;
-    for (auto [element_length, element_operation] : cig)
-    {
-        switch(element_operation.to_char())
-        {
-            case 'M':
-            case 'S':
+                [[fallthrough]];
             case 'I':
-            case 'X':
-            case '=':
-                current_length += element_length;
+                query_length += element_length;
+                if (!aligned_base_found)
+                {
+                    left_soft_clip = soft_clip;
+                    aligned_base_found = true;
+                }
+                soft_clip = 0;
                 break;
             case 'D':
             case 'N':
+                current_pos += element_length;
+                break;
+            case 'S':
+                query_length += element_length;
+                soft_clip += element_length;
+                break;
             case 'H':
             case 'P': // do nothing
                 break;
             // default: all other characters will be mapped to M
         }
     }
-    return current_length;
-}
-
-int32_t AlignedSegment::get_query_end() const
-{
-    if (orientation == strand::forward)
-    {
-        return get_query_length() - get_right_soft_clip();
-    }
-    else
-    {
-        return get_query_length() - get_left_soft_clip();
-    }
+    // Without any aligned base, all soft clips are on both sides.
+    if (!aligned_base_found)
+        left_soft_clip = soft_clip;
+    right_soft_clip = soft_clip;
+    // Decrement by 1 to jump back to the last aligned base
+    reference_end = current_pos - 1;
 }
 
 bool operator<(AlignedSegment const & lhs, AlignedSegment const & rhs)
@@ -135,7 +69,7 @@ bool operator==(AlignedSegment const & lhs, AlignedSegment const & rhs)
 {
     return lhs.orientation == rhs.orientation &&
            lhs.ref_name == rhs.ref_name &&
-           lhs.pos == rhs.pos &&
+           lhs.get_reference_start() == rhs.get_reference_start() &&
            lhs.mapq == rhs.mapq &&
-           lhs.cig == rhs.cig;
+           lhs.get_cigar() == rhs.get_cigar();
 }
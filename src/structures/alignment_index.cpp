@@ -0,0 +1,204 @@
+#include "structures/alignment_index.hpp"
+
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap and munmap
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close
+
+#include <algorithm>    // for std::max and std::min
+#include <array>        // for std::array
+#include <cstddef>      // for offsetof
+#include <cstring>      // for std::memcpy
+#include <fstream>      // for std::ofstream
+#include <stdexcept>    // for std::runtime_error
+#include <utility>      // for std::exchange
+
+namespace
+{
+
+constexpr std::array<char, 8> magic{'i', 'G', 'V', 'i', 'n', 'd', 'e', 'x'};
+
+/*! \brief The header of an index file. It is followed by two uint64_t per reference sequence (the first window and the
+ *         number of windows) and by the file positions of the windows.
+ */
+struct IndexHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t amount_references;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(IndexHeader) == 24);
+
+//! \brief FNV-1a hash of the bytes, continuing from `hash`.
+uint64_t fnv1a(void const * data, size_t const size, uint64_t hash = 14695981039346656037ull)
+{
+    unsigned char const * bytes = static_cast<unsigned char const *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+//! \brief The checksum covers the header (without the checksum itself), the reference table and the windows.
+uint64_t index_checksum(IndexHeader const & header,
+                        uint64_t const * reference_table,
+                        int64_t const * windows,
+                        size_t const amount_windows)
+{
+    uint64_t hash = fnv1a(&header, offsetof(IndexHeader, checksum));
+    hash = fnv1a(reference_table, 2 * header.amount_references * sizeof(uint64_t), hash);
+    return fnv1a(windows, amount_windows * sizeof(int64_t), hash);
+}
+
+} // namespace
+
+AlignmentIndex::AlignmentIndex(std::filesystem::path const & index_file_path)
+{
+    int const fd = open(index_file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error{"Could not open the index file '" + index_file_path.string() + "'."};
+
+    struct stat file_status{};
+    if (fstat(fd, &file_status) == 0 && static_cast<size_t>(file_status.st_size) >= sizeof(IndexHeader))
+    {
+        mapping_size = file_status.st_size;
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+    }
+    close(fd);
+
+    // The destructor is not called if the constructor throws, thus the mapping is released here.
+    auto throw_format_error = [&] ()
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+        throw std::runtime_error{"The index file '" + index_file_path.string() + "' is invalid or was created by "
+                                 "another version of iGenVar."};
+    };
+    if (mapping == nullptr)
+        throw_format_error();
+
+    IndexHeader header{};
+    std::memcpy(&header, mapping, sizeof(IndexHeader));
+    amount_references = header.amount_references;
+    size_t const windows_offset = sizeof(IndexHeader) + 2 * sizeof(uint64_t) * size_t{amount_references};
+    reference_table = reinterpret_cast<uint64_t const *>(static_cast<char const *>(mapping) + sizeof(IndexHeader));
+    all_windows = reinterpret_cast<int64_t const *>(static_cast<char const *>(mapping) + windows_offset);
+
+    if (header.magic != magic || header.version != format_version || windows_offset > mapping_size ||
+        (mapping_size - windows_offset) % sizeof(int64_t) != 0)
+    {
+        throw_format_error();
+    }
+    size_t const amount_windows = (mapping_size - windows_offset) / sizeof(int64_t);
+    if (header.checksum != index_checksum(header, reference_table, all_windows, amount_windows))
+        throw_format_error();
+
+    // All windows of the reference table have to lie inside of the file.
+    for (uint32_t ref_id = 0; ref_id < amount_references; ++ref_id)
+    {
+        if (reference_table[2 * ref_id] + reference_table[2 * ref_id + 1] > amount_windows)
+            throw_format_error();
+    }
+}
+
+AlignmentIndex::AlignmentIndex(AlignmentIndex && other) noexcept :
+    mapping{std::exchange(other.mapping, nullptr)},
+    mapping_size{std::exchange(other.mapping_size, 0)},
+    amount_references{std::exchange(other.amount_references, 0)},
+    reference_table{std::exchange(other.reference_table, nullptr)},
+    all_windows{std::exchange(other.all_windows, nullptr)}
+{}
+
+AlignmentIndex & AlignmentIndex::operator=(AlignmentIndex && other) noexcept
+{
+    if (this != &other)
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+        mapping = std::exchange(other.mapping, nullptr);
+        mapping_size = std::exchange(other.mapping_size, 0);
+        amount_references = std::exchange(other.amount_references, 0);
+        reference_table = std::exchange(other.reference_table, nullptr);
+        all_windows = std::exchange(other.all_windows, nullptr);
+    }
+    return *this;
+}
+
+AlignmentIndex::~AlignmentIndex()
+{
+    if (mapping != nullptr)
+        munmap(mapping, mapping_size);
+}
+
+std::span<int64_t const> AlignmentIndex::windows(int32_t const ref_id) const noexcept
+{
+    if (ref_id < 0 || static_cast<uint32_t>(ref_id) >= amount_references)
+        return {};
+    return {all_windows + reference_table[2 * ref_id], reference_table[2 * ref_id + 1]};
+}
+
+std::streamoff AlignmentIndex::first_overlap(int32_t const ref_id, int32_t const start, int32_t const end) const noexcept
+{
+    // A record overlapping the region overlaps the first window of the region, which is overlapped by any record, or
+    // starts behind it. The records are sorted by their start, thus none is in front of the smallest file position of
+    // this window.
+    std::span<int64_t const> const ref_windows = windows(ref_id);
+    if (start >= end)
+        return -1;
+    size_t const last_window = std::min<size_t>((end - 1) / window_size + 1, ref_windows.size());
+    for (size_t window = std::max(start, 0) / window_size; window < last_window; ++window)
+    {
+        if (ref_windows[window] >= 0)
+            return ref_windows[window];
+    }
+    return -1;
+}
+
+void AlignmentIndexBuilder::add(int32_t const ref_id,
+                                int32_t const start,
+                                int32_t const end,
+                                std::streamoff const file_position)
+{
+    if (static_cast<size_t>(ref_id) >= windows_per_reference.size())
+        windows_per_reference.resize(ref_id + 1);
+
+    // The records are added in the order of the file, thus the first record overlapping a window has the smallest
+    // file position.
+    std::vector<int64_t> & windows = windows_per_reference[ref_id];
+    size_t const last_window = (end - 1) / AlignmentIndex::window_size;
+    if (windows.size() <= last_window)
+        windows.resize(last_window + 1, -1);
+    for (size_t window = start / AlignmentIndex::window_size; window <= last_window; ++window)
+    {
+        if (windows[window] < 0)
+            windows[window] = file_position;
+    }
+}
+
+void AlignmentIndexBuilder::write(std::filesystem::path const & index_file_path) const
+{
+    IndexHeader header{magic, AlignmentIndex::format_version, static_cast<uint32_t>(windows_per_reference.size()), 0};
+    std::vector<uint64_t> reference_table{};
+    std::vector<int64_t> all_windows{};
+    for (std::vector<int64_t> const & windows : windows_per_reference)
+    {
+        reference_table.push_back(all_windows.size());
+        reference_table.push_back(windows.size());
+        all_windows.insert(all_windows.end(), windows.begin(), windows.end());
+    }
+    header.checksum = index_checksum(header, reference_table.data(), all_windows.data(), all_windows.size());
+
+    std::ofstream out{index_file_path, std::ios_base::binary | std::ios_base::out};
+    out.write(reinterpret_cast<char const *>(&header), sizeof(IndexHeader));
+    out.write(reinterpret_cast<char const *>(reference_table.data()), reference_table.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<char const *>(all_windows.data()), all_windows.size() * sizeof(int64_t));
+    out.close();
+    if (!out)
+        throw std::runtime_error{"Could not write the index file '" + index_file_path.string() + "'."};
+}
@@ -1,109 +1,100 @@
 #include "structures/cluster.hpp"
 
+#include <algorithm>    // for std::sort and std::ranges::equal
 #include <cmath>        // for std::round
 #include <stdexcept>    // for std::runtime_error
 
-size_t Cluster::get_cluster_size() const
-{
-    return members.size();
-}
-
-Breakend Cluster::get_average_mate1() const
+/*! \brief Returns the average of the given mates of all members.
+ *         All members are required to have identical sequence names and orientations for this mate.
+ *
+ * \param[in] members - the members of a cluster, must not be empty
+ * \param[in] get_mate - a function returning the first or second mate of a junction
+ */
+template <typename get_mate_t>
+Breakend average_breakend(std::vector<Junction> const & members, get_mate_t get_mate)
 {
-    std::string seq_name{};
+    Breakend const & first_mate = get_mate(members[0]);
     uint64_t sum_positions = 0;
-    strand orientation{};
     // Iterate through members of the cluster
-    for (uint32_t i = 0; i < members.size(); ++i)
+    for (Junction const & member : members)
     {
-        Breakend mate1 = members[i].get_mate1();
-        if (i == 0)
-        {
-            seq_name = mate1.seq_name;
-            orientation = mate1.orientation;
-        }
-        else
+        Breakend const & mate = get_mate(member);
+        // Make sure that all members of the cluster have matching sequence names and orientations
+        if (mate.seq_name != first_mate.seq_name ||
+            mate.orientation != first_mate.orientation)
         {
-            // Make sure that all members of the cluster have matching sequence names and orientations
-            if (mate1.seq_name != seq_name ||
-                mate1.orientation != orientation)
-            {
-                throw std::runtime_error("Junctions with incompatible breakends were clustered together (different seq_name or orientation).");
-            }
+            throw std::runtime_error("Junctions with incompatible breakends were clustered together (different seq_name or orientation).");
         }
         // Add up breakend positions aross all members
-        sum_positions += mate1.position;
+        sum_positions += mate.position;
     }
     int32_t average_position = std::round(static_cast<double>(sum_positions) / members.size());
-    Breakend average_breakend{seq_name, average_position, orientation};
-    return average_breakend;
+    return Breakend{first_mate.seq_name, average_position, first_mate.orientation};
 }
 
-Breakend Cluster::get_average_mate2() const
+void Cluster::compute_statistics()
 {
-    std::string seq_name{};
-    uint64_t sum_positions = 0;
-    strand orientation{};
-    // Iterate through members of the cluster
-    for (uint32_t i = 0; i < members.size(); ++i)
+    if (members.empty())
+        return;
+
+    average_mate1 = average_breakend(members, [] (Junction const & junction) -> Breakend const &
     {
-        Breakend mate2 = members[i].get_mate2();
-        if (i == 0)
-        {
-            seq_name = mate2.seq_name;
-            orientation = mate2.orientation;
-        }
-        else
-        {
-            // Make sure that all members of the cluster have matching sequence types, names and orientations
-            if (mate2.seq_name != seq_name ||
-                mate2.orientation != orientation)
-            {
-                throw std::runtime_error("Junctions with incompatible breakends were clustered together (different seq_name or orientation).");
-            }
-        }
-        // Add up breakend positions aross all members
-        sum_positions += mate2.position;
-    }
-    int32_t average_position = std::round(static_cast<double>(sum_positions) / members.size());
-    Breakend average_breakend{seq_name, average_position, orientation};
-    return average_breakend;
-}
+        return junction.get_mate1();
+    });
+    average_mate2 = average_breakend(members, [] (Junction const & junction) -> Breakend const &
+    {
+        return junction.get_mate2();
+    });
 
-size_t Cluster::get_common_tandem_dup_count() const
-{
     size_t sum_counts = 0;
     size_t amount_zero_counts = 0;
+    size_t sum_sizes = 0;
     // Iterate through members of the cluster
-    for (size_t i = 0; i < members.size(); ++i)
+    for (Junction const & member : members)
     {
-        size_t current_count = members[i].get_tandem_dup_count();
+        size_t const current_count = member.get_tandem_dup_count();
         if (current_count == 0)
             ++amount_zero_counts;
         else
-            sum_counts += members[i].get_tandem_dup_count();
+            sum_counts += current_count;
+        sum_sizes += member.get_inserted_sequence().size();
     }
     // TODO (irallia 12.08.21): This 3 is free choosen and other values could be tested.
     // If two thirds of the junctions have a 0 tandem_dup_count, than its probably no tandem duplication.
     if (amount_zero_counts > std::round(members.size() / 3.0))
-        return 0;
+        common_tandem_dup_count = 0;
     else
-        return std::round(static_cast<double>(sum_counts) / members.size());
+        common_tandem_dup_count = std::round(static_cast<double>(sum_counts) / members.size());
+
+    average_inserted_sequence_size = std::round(static_cast<double>(sum_sizes) / members.size());
+}
+
+size_t Cluster::get_cluster_size() const
+{
+    return members.size();
+}
+
+Breakend const & Cluster::get_average_mate1() const
+{
+    return average_mate1;
+}
+
+Breakend const & Cluster::get_average_mate2() const
+{
+    return average_mate2;
+}
+
+size_t Cluster::get_common_tandem_dup_count() const
+{
+    return common_tandem_dup_count;
 }
 
 size_t Cluster::get_average_inserted_sequence_size() const
 {
-    size_t sum_sizes = 0;
-    // Iterate through members of the cluster
-    for (size_t i = 0; i < members.size(); ++i)
-    {
-        sum_sizes += members[i].get_inserted_sequence().size();
-    }
-    size_t average_size = std::round(static_cast<double>(sum_sizes) / members.size());
-    return average_size;
+    return average_inserted_sequence_size;
 }
 
-std::vector<Junction> Cluster::get_members() const
+std::vector<Junction> const & Cluster::get_members() const
 {
     return members;
 }
@@ -121,9 +112,20 @@ bool operator<(Cluster const & lhs, Cluster const & rhs)
 
 bool operator==(Cluster const & lhs, Cluster const & rhs)
 {
-    std::vector<Junction> lhs_members = lhs.get_members();
-    std::sort(lhs_members.begin(), lhs_members.end());
-    std::vector<Junction> rhs_members = rhs.get_members();
-    std::sort(rhs_members.begin(), rhs_members.end());
-    return (lhs_members == rhs_members);
+    if (lhs.get_cluster_size() != rhs.get_cluster_size())
+        return false;
+
+    // Compare the members in sorted order without copying the junctions.
+    auto sorted_members = [] (Cluster const & cluster)
+    {
+        std::vector<Junction const *> members{};
+        members.reserve(cluster.get_cluster_size());
+        for (Junction const & junction : cluster.get_members())
+            members.push_back(&junction);
+        std::sort(members.begin(), members.end(), [] (Junction const * a, Junction const * b) { return *a < *b; });
+        return members;
+    };
+    return std::ranges::equal(sorted_members(lhs), sorted_members(rhs), [] (Junction const * a, Junction const * b) {
+        return *a == *b;
+    });
 }
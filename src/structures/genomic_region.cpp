@@ -0,0 +1,111 @@
+#include "structures/genomic_region.hpp"
+
+#include <charconv>     // for std::from_chars
+#include <fstream>      // for std::ifstream
+#include <stdexcept>    // for std::invalid_argument and std::runtime_error
+#include <string_view>  // for std::string_view
+#include <tuple>        // for std::tie
+
+/*! \brief Adds the "chr" prefix to a reference name, if it is missing.
+ *
+ * \details As the chromosome names can differ between "1" and "chr1", the reference names of the alignment files get
+ *          the "chr" prefix. Thus, the reference names of regions need it as well.
+ */
+std::string add_chr_prefix(std::string_view const seq_name)
+{
+    return seq_name.starts_with("chr") ? std::string{seq_name} : "chr" + std::string{seq_name};
+}
+
+/*! \brief Parses a non-negative coordinate, which may contain thousands separators.
+ *
+ * \returns Whether the whole string is a valid coordinate.
+ */
+bool parse_coordinate(std::string_view const str, int32_t & coordinate)
+{
+    std::string digits{};
+    for (char const c : str)
+    {
+        if (c != ',')
+            digits += c;
+    }
+    auto const [end, error_code] = std::from_chars(digits.data(), digits.data() + digits.size(), coordinate);
+    return !digits.empty() && error_code == std::errc{} && end == digits.data() + digits.size() && coordinate >= 0;
+}
+
+GenomicRegion parse_region(std::string const & region_string)
+{
+    std::invalid_argument const format_error{"Invalid region '" + region_string + "'. The format is chr:start-end, "
+                                             "chr:start or chr with 1-based coordinates and start <= end."};
+
+    std::string_view const region{region_string};
+    size_t const colon_pos = region.rfind(':');
+    if (region.substr(0, colon_pos).empty())
+        throw format_error;
+
+    GenomicRegion result{add_chr_prefix(region.substr(0, colon_pos))};
+
+    if (colon_pos != std::string_view::npos)
+    {
+        std::string_view const interval = region.substr(colon_pos + 1);
+        size_t const dash_pos = interval.find('-');
+        int32_t start{};
+        if (!parse_coordinate(interval.substr(0, dash_pos), start) || start == 0)
+            throw format_error;
+        // Convert to a 0-based half-open interval.
+        result.start = start - 1;
+        if (dash_pos != std::string_view::npos)
+        {
+            if (!parse_coordinate(interval.substr(dash_pos + 1), result.end) || result.end < start)
+                throw format_error;
+        }
+    }
+    return result;
+}
+
+std::vector<GenomicRegion> read_regions_bed(std::filesystem::path const & bed_file_path)
+{
+    std::ifstream bed_file{bed_file_path};
+    if (!bed_file.good() || !bed_file.is_open())
+        throw std::runtime_error{"Could not open file '" + bed_file_path.string() + "' for reading."};
+
+    std::vector<GenomicRegion> regions{};
+    std::string line{};
+    size_t line_number = 0;
+    while (std::getline(bed_file, line))
+    {
+        ++line_number;
+        if (line.empty() || line.starts_with("#") || line.starts_with("track") || line.starts_with("browser"))
+            continue;
+
+        std::string_view columns{line};
+        std::string_view fields[3]{};
+        for (std::string_view & field : fields)
+        {
+            size_t const tab_pos = columns.find('\t');
+            field = columns.substr(0, tab_pos);
+            columns = (tab_pos == std::string_view::npos) ? std::string_view{} : columns.substr(tab_pos + 1);
+        }
+
+        GenomicRegion region{add_chr_prefix(fields[0])};
+        if (fields[0].empty() ||
+            !parse_coordinate(fields[1], region.start) ||
+            !parse_coordinate(fields[2], region.end) ||
+            region.end < region.start)
+        {
+            throw std::invalid_argument{"Invalid BED line " + std::to_string(line_number) + " in '" +
+                                        bed_file_path.string() + "': " + line};
+        }
+        regions.push_back(std::move(region));
+    }
+    return regions;
+}
+
+bool operator<(GenomicRegion const & lhs, GenomicRegion const & rhs)
+{
+    return std::tie(lhs.seq_name, lhs.start, lhs.end) < std::tie(rhs.seq_name, rhs.start, rhs.end);
+}
+
+bool operator==(GenomicRegion const & lhs, GenomicRegion const & rhs)
+{
+    return std::tie(lhs.seq_name, lhs.start, lhs.end) == std::tie(rhs.seq_name, rhs.start, rhs.end);
+}
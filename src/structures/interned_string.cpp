@@ -0,0 +1,38 @@
+#include "structures/interned_string.hpp"
+
+#include <array>            // for std::array
+#include <mutex>            // for std::mutex and std::lock_guard
+#include <unordered_set>    // for std::unordered_set
+
+std::string const * InternedString::intern(std::string const & value)
+{
+    if (value.empty())
+        return &empty_string;
+
+    // The junctions of an alignment share the reference sequence names. Thus, the last looked up strings of each
+    // thread are checked first, which avoids locking the pool for most lookups.
+    constexpr size_t cache_size = 4;
+    thread_local std::array<std::string const *, cache_size> cache{&empty_string, &empty_string,
+                                                                   &empty_string, &empty_string};
+    thread_local size_t next_cache_slot = 0;
+
+    for (std::string const * cached : cache)
+    {
+        if (*cached == value)
+            return cached;
+    }
+
+    // The nodes of an unordered_set are never moved, so the addresses of the pooled strings stay valid.
+    static std::mutex pool_mutex{};
+    static std::unordered_set<std::string> pool{};
+
+    std::string const * pooled{};
+    {
+        std::lock_guard<std::mutex> lock{pool_mutex};
+        pooled = &*pool.insert(value).first;
+    }
+
+    cache[next_cache_slot] = pooled;
+    next_cache_slot = (next_cache_slot + 1) % cache_size;
+    return pooled;
+}
@@ -1,16 +1,16 @@
 #include "structures/junction.hpp"
 
-Breakend Junction::get_mate1() const
+Breakend const & Junction::get_mate1() const
 {
     return mate1;
 }
 
-Breakend Junction::get_mate2() const
+Breakend const & Junction::get_mate2() const
 {
     return mate2;
 }
 
-seqan3::dna5_vector Junction::get_inserted_sequence() const
+seqan3::bitpacked_sequence<seqan3::dna5> const & Junction::get_inserted_sequence() const
 {
     return inserted_sequence;
 }
@@ -20,9 +20,10 @@ size_t Junction::get_tandem_dup_count() const
     return tandem_dup_count;
 }
 
-std::string Junction::get_read_name() const
+std::string const & Junction::get_read_name() const
 {
-    return read_name;
+    static std::string const empty_read_name{};
+    return read_name ? *read_name : empty_read_name;
 }
 
 bool operator<(Junction const & lhs, Junction const & rhs)
@@ -0,0 +1,522 @@
+#include "structures/junction_dump.hpp"
+
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap and munmap
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close
+
+#include <algorithm>    // for std::sort
+#include <array>        // for std::array
+#include <cstdlib>      // for mkstemps
+#include <cstring>      // for std::memcpy
+#include <queue>        // for std::priority_queue
+#include <stdexcept>    // for std::runtime_error
+#include <utility>      // for std::exchange
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+namespace
+{
+
+constexpr std::array<char, 8> magic{'i', 'G', 'V', 'd', 'u', 'm', 'p', '\0'};
+
+/*! \brief The header of a dump file. It is followed by the junction records, for a cluster dump by amount_clusters + 1
+ *         offsets of the first junction of each cluster, by the reference table, by amount_strings + 1 offsets of the
+ *         strings in the string table, by the string table and by the inserted sequences.
+ */
+struct DumpHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t content;
+    uint32_t amount_references;
+    uint32_t amount_strings;
+    uint64_t amount_junctions;
+    uint64_t amount_clusters;
+    uint64_t strings_size;
+};
+
+//! \brief A junction, whose names are indices in the string table and whose inserted sequence is an offset.
+struct JunctionRecord
+{
+    uint32_t mate1_seq_name;
+    int32_t mate1_position;
+    uint32_t mate2_seq_name;
+    int32_t mate2_position;
+    uint32_t read_name;
+    uint8_t mate1_orientation;
+    uint8_t mate2_orientation;
+    uint16_t reserved;
+    uint32_t tandem_dup_count;
+    uint32_t inserted_sequence_length;
+    uint64_t inserted_sequence_offset;
+};
+
+//! \brief A reference sequence, whose name is an index in the string table.
+struct ReferenceRecord
+{
+    uint32_t name;
+    int32_t length;
+};
+
+static_assert(sizeof(DumpHeader) == 48);
+static_assert(sizeof(JunctionRecord) == 40);
+static_assert(sizeof(ReferenceRecord) == 8);
+
+//! \brief The bases of an inserted sequence are stored as ranks in base 5, three bases per byte.
+constexpr size_t bases_per_byte = 3;
+constexpr std::array<unsigned, bases_per_byte> powers_of_5{1, 5, 25};
+
+} // namespace
+
+/* -------- JunctionDump -------- */
+
+JunctionDump::JunctionDump(std::filesystem::path const & dump_file_path)
+{
+    int const fd = open(dump_file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error{"Could not open the dump file '" + dump_file_path.string() + "'."};
+
+    struct stat file_status{};
+    if (fstat(fd, &file_status) == 0 && static_cast<size_t>(file_status.st_size) >= sizeof(DumpHeader))
+    {
+        mapping_size = file_status.st_size;
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+    }
+    close(fd);
+
+    // The destructor is not called if the constructor throws, thus the mapping is released here.
+    auto throw_format_error = [&] ()
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+        throw std::runtime_error{"The dump file '" + dump_file_path.string() + "' is invalid or was created by "
+                                 "another version of iGenVar."};
+    };
+    if (mapping == nullptr)
+        throw_format_error();
+
+    DumpHeader header{};
+    std::memcpy(&header, mapping, sizeof(DumpHeader));
+    if (header.magic != magic || header.version != format_version || header.content > 1)
+        throw_format_error();
+
+    // The sections are checked one after the other, such that no offset can overflow.
+    content = static_cast<dump_content>(header.content);
+    amount_junctions = header.amount_junctions;
+    amount_clusters = (content == dump_content::clusters) ? header.amount_clusters : 0;
+    amount_references = header.amount_references;
+    size_t const max_size = mapping_size - sizeof(DumpHeader);
+    if (amount_clusters >= max_size / sizeof(uint64_t))
+        throw_format_error();
+    size_t const cluster_offsets_size = (content == dump_content::clusters) ? amount_clusters + 1 : 0;
+    if (amount_junctions > max_size / sizeof(JunctionRecord) ||
+        cluster_offsets_size > (max_size - amount_junctions * sizeof(JunctionRecord)) / sizeof(uint64_t))
+    {
+        throw_format_error();
+    }
+    references_offset = sizeof(DumpHeader) + amount_junctions * sizeof(JunctionRecord) +
+                        cluster_offsets_size * sizeof(uint64_t);
+    size_t const strings_offset = references_offset + size_t{amount_references} * sizeof(ReferenceRecord);
+    if (strings_offset + (size_t{header.amount_strings} + 1) * sizeof(uint64_t) > mapping_size)
+        throw_format_error();
+    size_t const string_table_offset = strings_offset + (size_t{header.amount_strings} + 1) * sizeof(uint64_t);
+    if (header.strings_size > mapping_size - string_table_offset)
+        throw_format_error();
+    sequences_offset = string_table_offset + header.strings_size;
+
+    char const * const data = static_cast<char const *>(mapping);
+    if (content == dump_content::clusters)
+    {
+        std::vector<uint64_t> cluster_offsets(cluster_offsets_size);
+        std::memcpy(cluster_offsets.data(),
+                    data + sizeof(DumpHeader) + amount_junctions * sizeof(JunctionRecord),
+                    cluster_offsets_size * sizeof(uint64_t));
+        for (size_t i = 1; i < cluster_offsets.size(); ++i)
+        {
+            if (cluster_offsets[i] < cluster_offsets[i - 1])
+                throw_format_error();
+        }
+        if (cluster_offsets.front() != 0 || cluster_offsets.back() != amount_junctions)
+            throw_format_error();
+    }
+
+    std::vector<uint64_t> string_offsets(size_t{header.amount_strings} + 1);
+    std::memcpy(string_offsets.data(), data + strings_offset, string_offsets.size() * sizeof(uint64_t));
+    if (string_offsets.front() != 0 || string_offsets.back() != header.strings_size)
+        throw_format_error();
+    strings.reserve(header.amount_strings);
+    for (size_t i = 0; i < header.amount_strings; ++i)
+    {
+        if (string_offsets[i + 1] < string_offsets[i])
+            throw_format_error();
+        strings.push_back(std::make_shared<std::string const>(data + string_table_offset + string_offsets[i],
+                                                              data + string_table_offset + string_offsets[i + 1]));
+    }
+
+    for (uint32_t i = 0; i < amount_references; ++i)
+    {
+        ReferenceRecord reference{};
+        std::memcpy(&reference, data + references_offset + i * sizeof(ReferenceRecord), sizeof(ReferenceRecord));
+        if (reference.name >= strings.size())
+            throw_format_error();
+    }
+}
+
+JunctionDump::JunctionDump(JunctionDump && other) noexcept :
+    mapping{std::exchange(other.mapping, nullptr)},
+    mapping_size{std::exchange(other.mapping_size, 0)},
+    content{other.content},
+    amount_junctions{std::exchange(other.amount_junctions, 0)},
+    amount_clusters{std::exchange(other.amount_clusters, 0)},
+    amount_references{std::exchange(other.amount_references, 0)},
+    references_offset{other.references_offset},
+    sequences_offset{other.sequences_offset},
+    strings{std::move(other.strings)}
+{}
+
+JunctionDump & JunctionDump::operator=(JunctionDump && other) noexcept
+{
+    if (this != &other)
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+        mapping = std::exchange(other.mapping, nullptr);
+        mapping_size = std::exchange(other.mapping_size, 0);
+        content = other.content;
+        amount_junctions = std::exchange(other.amount_junctions, 0);
+        amount_clusters = std::exchange(other.amount_clusters, 0);
+        amount_references = std::exchange(other.amount_references, 0);
+        references_offset = other.references_offset;
+        sequences_offset = other.sequences_offset;
+        strings = std::move(other.strings);
+    }
+    return *this;
+}
+
+JunctionDump::~JunctionDump()
+{
+    if (mapping != nullptr)
+        munmap(mapping, mapping_size);
+}
+
+Junction JunctionDump::junction(size_t const index) const
+{
+    char const * const data = static_cast<char const *>(mapping);
+    JunctionRecord record{};
+    std::memcpy(&record, data + sizeof(DumpHeader) + index * sizeof(JunctionRecord), sizeof(JunctionRecord));
+
+    size_t const sequences_size = mapping_size - sequences_offset;
+    size_t const packed_length = (size_t{record.inserted_sequence_length} + bases_per_byte - 1) / bases_per_byte;
+    if (record.mate1_seq_name >= strings.size() || record.mate2_seq_name >= strings.size() ||
+        record.read_name >= strings.size() || record.mate1_orientation > 1 || record.mate2_orientation > 1 ||
+        record.inserted_sequence_offset > sequences_size ||
+        packed_length > sequences_size - record.inserted_sequence_offset)
+    {
+        throw std::runtime_error{"The junction " + std::to_string(index) + " of the dump file is invalid."};
+    }
+
+    seqan3::dna5_vector inserted_sequence(record.inserted_sequence_length);
+    unsigned char const * const packed = reinterpret_cast<unsigned char const *>(data + sequences_offset) +
+                                         record.inserted_sequence_offset;
+    for (size_t i = 0; i < inserted_sequence.size(); ++i)
+        inserted_sequence[i].assign_rank(packed[i / bases_per_byte] / powers_of_5[i % bases_per_byte] % 5);
+
+    return Junction{Breakend{*strings[record.mate1_seq_name], record.mate1_position,
+                             static_cast<strand>(record.mate1_orientation)},
+                    Breakend{*strings[record.mate2_seq_name], record.mate2_position,
+                             static_cast<strand>(record.mate2_orientation)},
+                    inserted_sequence,
+                    record.tandem_dup_count,
+                    strings[record.read_name]};
+}
+
+std::vector<Junction> JunctionDump::junctions() const
+{
+    std::vector<Junction> all_junctions{};
+    all_junctions.reserve(amount_junctions);
+    for (size_t i = 0; i < amount_junctions; ++i)
+        all_junctions.push_back(junction(i));
+    return all_junctions;
+}
+
+std::vector<Cluster> JunctionDump::clusters() const
+{
+    std::vector<Cluster> all_clusters{};
+    all_clusters.reserve(amount_clusters);
+    char const * const cluster_offsets = static_cast<char const *>(mapping) + sizeof(DumpHeader) +
+                                         amount_junctions * sizeof(JunctionRecord);
+    for (size_t c = 0; c < amount_clusters; ++c)
+    {
+        std::array<uint64_t, 2> range{};
+        std::memcpy(range.data(), cluster_offsets + c * sizeof(uint64_t), sizeof(range));
+        std::vector<Junction> members{};
+        members.reserve(range[1] - range[0]);
+        for (uint64_t i = range[0]; i < range[1]; ++i)
+            members.push_back(junction(i));
+        all_clusters.emplace_back(std::move(members));
+    }
+    return all_clusters;
+}
+
+std::map<std::string, int32_t> JunctionDump::references_lengths() const
+{
+    std::map<std::string, int32_t> lengths{};
+    for (uint32_t i = 0; i < amount_references; ++i)
+    {
+        ReferenceRecord reference{};
+        std::memcpy(&reference,
+                    static_cast<char const *>(mapping) + references_offset + i * sizeof(ReferenceRecord),
+                    sizeof(ReferenceRecord));
+        lengths.emplace(*strings[reference.name], reference.length);
+    }
+    return lengths;
+}
+
+/* -------- JunctionDumpWriter -------- */
+
+JunctionDumpWriter::JunctionDumpWriter(std::filesystem::path const & dump_file_path,
+                                       std::map<std::string, int32_t> const & references_lengths,
+                                       dump_content const content) :
+    file{dump_file_path, std::ios_base::binary | std::ios_base::out},
+    dump_file_path{dump_file_path},
+    content{content}
+{
+    if (!file.is_open())
+        throw std::runtime_error{"Could not open file '" + dump_file_path.string() + "' for writing."};
+
+    if (content == dump_content::clusters)
+        cluster_offsets.push_back(0);
+    for (auto const & [name, length] : references_lengths)
+        references.emplace_back(get_string_id(name), length);
+
+    // The header is written by close(), when the amounts are known.
+    DumpHeader const header{};
+    file.write(reinterpret_cast<char const *>(&header), sizeof(DumpHeader));
+}
+
+JunctionDumpWriter::~JunctionDumpWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // Errors can only be reported by calling close() explicitly.
+    }
+}
+
+uint32_t JunctionDumpWriter::get_string_id(InternedString const & value)
+{
+    auto const [it, inserted] = string_ids.emplace(&value.get(), strings.size());
+    if (inserted)
+        strings.push_back(&value.get());
+    return it->second;
+}
+
+uint32_t JunctionDumpWriter::get_read_name_id(std::string const & read_name)
+{
+    auto const [it, inserted] = read_name_ids.try_emplace(read_name, strings.size());
+    if (inserted)
+        strings.push_back(&it->first);
+    return it->second;
+}
+
+void JunctionDumpWriter::add(Junction const & junction)
+{
+    Breakend const & mate1 = junction.get_mate1();
+    Breakend const & mate2 = junction.get_mate2();
+    JunctionRecord record{.mate1_seq_name = get_string_id(mate1.seq_name),
+                          .mate1_position = mate1.position,
+                          .mate2_seq_name = get_string_id(mate2.seq_name),
+                          .mate2_position = mate2.position,
+                          .read_name = get_read_name_id(junction.get_read_name()),
+                          .mate1_orientation = static_cast<uint8_t>(mate1.orientation),
+                          .mate2_orientation = static_cast<uint8_t>(mate2.orientation),
+                          .reserved = 0,
+                          .tandem_dup_count = static_cast<uint32_t>(junction.get_tandem_dup_count()),
+                          .inserted_sequence_length = static_cast<uint32_t>(junction.get_inserted_sequence().size()),
+                          .inserted_sequence_offset = sequences.size()};
+
+    unsigned packed = 0;
+    size_t i = 0;
+    for (seqan3::dna5 const base : junction.get_inserted_sequence())
+    {
+        packed += base.to_rank() * powers_of_5[i % bases_per_byte];
+        if (++i % bases_per_byte == 0)
+        {
+            sequences.push_back(static_cast<char>(packed));
+            packed = 0;
+        }
+    }
+    if (i % bases_per_byte != 0)
+        sequences.push_back(static_cast<char>(packed));
+
+    file.write(reinterpret_cast<char const *>(&record), sizeof(JunctionRecord));
+    ++amount_junctions;
+}
+
+void JunctionDumpWriter::add(Cluster const & cluster)
+{
+    if (content != dump_content::clusters)
+        throw std::logic_error{"A cluster was added to a junction dump."};
+
+    for (Junction const & junction : cluster.get_members())
+        add(junction);
+    cluster_offsets.push_back(amount_junctions);
+}
+
+void JunctionDumpWriter::close()
+{
+    if (closed)
+        return;
+    closed = true;
+
+    file.write(reinterpret_cast<char const *>(cluster_offsets.data()), cluster_offsets.size() * sizeof(uint64_t));
+    for (auto const & [name, length] : references)
+    {
+        ReferenceRecord const reference{name, length};
+        file.write(reinterpret_cast<char const *>(&reference), sizeof(ReferenceRecord));
+    }
+
+    uint64_t string_offset = 0;
+    file.write(reinterpret_cast<char const *>(&string_offset), sizeof(uint64_t));
+    for (std::string const * value : strings)
+    {
+        string_offset += value->size();
+        file.write(reinterpret_cast<char const *>(&string_offset), sizeof(uint64_t));
+    }
+    for (std::string const * value : strings)
+        file.write(value->data(), value->size());
+    file.write(sequences.data(), sequences.size());
+
+    DumpHeader const header{.magic = magic,
+                            .version = JunctionDump::format_version,
+                            .content = static_cast<uint32_t>(content),
+                            .amount_references = static_cast<uint32_t>(references.size()),
+                            .amount_strings = static_cast<uint32_t>(strings.size()),
+                            .amount_junctions = amount_junctions,
+                            .amount_clusters = (cluster_offsets.empty()) ? 0 : cluster_offsets.size() - 1,
+                            .strings_size = string_offset};
+    file.seekp(0);
+    file.write(reinterpret_cast<char const *>(&header), sizeof(DumpHeader));
+    file.close();
+    if (!file)
+        throw std::runtime_error{"Could not write the dump file '" + dump_file_path.string() + "'."};
+}
+
+/* -------- JunctionSorter -------- */
+
+JunctionSorter::JunctionSorter(std::map<std::string, int32_t> const & references_lengths,
+                               size_t const junctions_per_run) :
+    references_lengths{references_lengths},
+    junctions_per_run{std::max<size_t>(junctions_per_run, 1)}
+{}
+
+JunctionSorter::~JunctionSorter()
+{
+    spill.reset();
+    if (!spill_file_path.empty())
+    {
+        std::error_code error{};
+        std::filesystem::remove(spill_file_path, error);
+    }
+}
+
+void JunctionSorter::spill_buffer()
+{
+    if (spill == nullptr)
+    {
+        // The file is created with a unique name, such that concurrent runs sharing the directory do not collide.
+        std::string path = (std::filesystem::temp_directory_path() / "iGenVar_spill_XXXXXX.igvd").string();
+        int const fd = mkstemps(path.data(), 5);
+        if (fd < 0)
+            throw std::runtime_error{"Could not create a temporary file '" + path + "'."};
+        close(fd);
+        spill_file_path = path;
+        spill = std::make_unique<JunctionDumpWriter>(spill_file_path, references_lengths, dump_content::junctions);
+    }
+
+    std::sort(buffer.begin(), buffer.end());
+    for (Junction const & junction : buffer)
+        spill->add(junction);
+    run_ends.push_back((run_ends.empty() ? 0 : run_ends.back()) + buffer.size());
+    buffer.clear();
+}
+
+void JunctionSorter::add(Junction && junction)
+{
+    buffer.push_back(std::move(junction));
+    if (buffer.size() >= junctions_per_run)
+        spill_buffer();
+}
+
+void JunctionSorter::merge(int32_t const partition_max_distance,
+                           size_t const junctions_per_batch,
+                           std::function<void(std::vector<Junction> &)> const & process_batch)
+{
+    std::vector<Junction> batch{};
+    auto add_to_batch = [&] (Junction && junction)
+    {
+        if (batch.size() >= junctions_per_batch &&
+            (junction.get_mate1().seq_name != batch.back().get_mate1().seq_name ||
+             junction.get_mate1().orientation != batch.back().get_mate1().orientation ||
+             junction.get_mate1().position - batch.back().get_mate1().position > partition_max_distance))
+        {
+            process_batch(batch);
+            batch.clear();
+        }
+        batch.push_back(std::move(junction));
+    };
+
+    // Without a spilled run, the buffer is sorted in memory.
+    if (spill == nullptr)
+    {
+        std::sort(buffer.begin(), buffer.end());
+        for (Junction & junction : buffer)
+            add_to_batch(std::move(junction));
+        buffer.clear();
+    }
+    else
+    {
+        if (!buffer.empty())
+            spill_buffer();
+        spill->close();
+        spill.reset();
+        JunctionDump const spilled{spill_file_path};
+
+        // The heap holds the next junction of each run, the smallest on top. Equal junctions are taken in the order of
+        // their runs, such that the result does not depend on the heap.
+        using head_t = std::pair<Junction, size_t>;
+        auto const greater = [] (head_t const & a, head_t const & b)
+        {
+            return b.first < a.first || (!(a.first < b.first) && b.second < a.second);
+        };
+        std::priority_queue<head_t, std::vector<head_t>, decltype(greater)> heads{greater};
+        std::vector<size_t> next_of_run(run_ends.size());
+        for (size_t run = 0; run < run_ends.size(); ++run)
+        {
+            next_of_run[run] = (run == 0) ? 0 : run_ends[run - 1];
+            if (next_of_run[run] < run_ends[run])
+                heads.emplace(spilled.junction(next_of_run[run]++), run);
+        }
+        while (!heads.empty())
+        {
+            // The top of a priority queue is const, thus the junction is copied before it is popped.
+            auto [junction, run] = heads.top();
+            heads.pop();
+            if (next_of_run[run] < run_ends[run])
+                heads.emplace(spilled.junction(next_of_run[run]++), run);
+            add_to_batch(std::move(junction));
+        }
+        run_ends.clear();
+        std::error_code error{};
+        std::filesystem::remove(std::exchange(spill_file_path, {}), error);
+    }
+
+    if (!batch.empty())
+        process_batch(batch);
+}
@@ -0,0 +1,272 @@
+#include "structures/reference_genome.hpp"
+
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap and munmap
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close
+
+#include <algorithm>    // for std::min and std::ranges::transform
+#include <cstring>      // for std::memchr and std::memcpy
+#include <fstream>      // for std::ifstream
+#include <sstream>      // for std::istringstream
+#include <stdexcept>    // for std::runtime_error
+#include <utility>      // for std::exchange
+
+using seqan3::operator""_dna5;
+
+namespace
+{
+
+/*! \brief Builds the index of a FASTA file like `samtools faidx`.
+ *
+ * \returns The index or an error message, if the lines of a sequence differ in length.
+ */
+std::pair<std::unordered_map<std::string, FastaIndexEntry>, std::string> build_fasta_index(char const * data,
+                                                                                           size_t const size)
+{
+    std::unordered_map<std::string, FastaIndexEntry> contigs{};
+    size_t position = 0;
+    // Returns the end of the line at `position`, i.e. the position of its line break or the end of the file.
+    auto line_end = [&] ()
+    {
+        void const * line_break = std::memchr(data + position, '\n', size - position);
+        return (line_break == nullptr) ? size : static_cast<size_t>(static_cast<char const *>(line_break) - data);
+    };
+
+    while (position < size)
+    {
+        size_t end = line_end();
+        if (data[position] != '>')
+        {
+            // Empty lines are skipped, any other line has to belong to a sequence.
+            if (end - position > 1 || (end - position == 1 && data[position] != '\r'))
+                return {{}, "contains a line outside of a sequence."};
+            position = end + 1;
+            continue;
+        }
+
+        size_t name_end = position + 1;
+        while (name_end < end && data[name_end] != ' ' && data[name_end] != '\t' && data[name_end] != '\r')
+            ++name_end;
+        std::string name{data + position + 1, name_end - position - 1};
+        position = end + 1;
+
+        FastaIndexEntry entry{0, position, 0, 0};
+        bool last_line = false; // A shorter line has to be the last line of a sequence.
+        while (position < size && data[position] != '>')
+        {
+            end = line_end();
+            uint64_t const line_width = end - position + 1;
+            uint64_t const line_bases = (end > position && data[end - 1] == '\r') ? end - position - 1 : end - position;
+            position = end + 1;
+            if (line_bases == 0)
+            {
+                last_line = true;
+                continue;
+            }
+            if (last_line || (entry.line_bases > 0 && (line_bases > entry.line_bases ||
+                                                       line_width - line_bases != entry.line_width - entry.line_bases)))
+            {
+                return {{}, "has lines of different lengths in the sequence " + name + "."};
+            }
+            if (entry.line_bases == 0)
+            {
+                entry.line_bases = line_bases;
+                entry.line_width = line_width;
+            }
+            last_line = line_bases < entry.line_bases;
+            entry.length += line_bases;
+        }
+        if (!contigs.try_emplace(name, entry).second)
+            return {{}, "contains the sequence " + name + " twice."};
+    }
+    return {std::move(contigs), ""};
+}
+
+} // namespace
+
+ReferenceGenome::ReferenceGenome(std::filesystem::path const & fasta_file_path)
+{
+    int const fd = open(fasta_file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error{"Could not open the reference genome '" + fasta_file_path.string() + "'."};
+
+    struct stat file_status{};
+    if (fstat(fd, &file_status) == 0 && file_status.st_size > 0)
+    {
+        mapping_size = file_status.st_size;
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = nullptr;
+    }
+    close(fd);
+
+    // The destructor is not called if the constructor throws, thus the mapping is released here.
+    auto throw_format_error = [&] (std::string const & reason)
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+        throw std::runtime_error{"The reference genome '" + fasta_file_path.string() + "' " + reason};
+    };
+    if (mapping == nullptr)
+        throw_format_error("could not be mapped.");
+
+    char const * data = static_cast<char const *>(mapping);
+    if (mapping_size >= 2 && data[0] == '\x1f' && data[1] == '\x8b')
+        throw_format_error("is compressed, but has to be an uncompressed FASTA file.");
+
+    std::filesystem::path const index_file_path = fasta_file_path.string() + ".fai";
+    if (std::filesystem::exists(index_file_path))
+    {
+        std::ifstream index_file{index_file_path};
+        for (std::string line{}; std::getline(index_file, line);)
+        {
+            std::istringstream fields{line};
+            std::string name{};
+            FastaIndexEntry entry{};
+            if (!(fields >> name >> entry.length >> entry.offset >> entry.line_bases >> entry.line_width))
+                throw_format_error("has an invalid index '" + index_file_path.string() + "'.");
+
+            // The last base of the sequence has to lie inside of the file.
+            if (entry.length > 0 &&
+                (entry.line_bases == 0 || entry.line_width < entry.line_bases ||
+                 entry.offset + (entry.length - 1) / entry.line_bases * entry.line_width +
+                 (entry.length - 1) % entry.line_bases >= mapping_size))
+            {
+                throw_format_error("does not match its index '" + index_file_path.string() + "'.");
+            }
+            contigs.emplace(std::move(name), entry);
+        }
+    }
+    else
+    {
+        auto [index, error] = build_fasta_index(data, mapping_size);
+        if (!error.empty())
+            throw_format_error(error);
+        contigs = std::move(index);
+    }
+}
+
+ReferenceGenome::ReferenceGenome(ReferenceGenome && other) noexcept :
+    mapping{std::exchange(other.mapping, nullptr)},
+    mapping_size{std::exchange(other.mapping_size, 0)},
+    contigs{std::move(other.contigs)}
+{}
+
+ReferenceGenome & ReferenceGenome::operator=(ReferenceGenome && other) noexcept
+{
+    if (this != &other)
+    {
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+        mapping = std::exchange(other.mapping, nullptr);
+        mapping_size = std::exchange(other.mapping_size, 0);
+        contigs = std::move(other.contigs);
+    }
+    return *this;
+}
+
+ReferenceGenome::~ReferenceGenome()
+{
+    if (mapping != nullptr)
+        munmap(mapping, mapping_size);
+}
+
+FastaIndexEntry const * ReferenceGenome::find(std::string const & name) const
+{
+    auto const it = contigs.find(name);
+    return (it == contigs.end()) ? nullptr : &it->second;
+}
+
+void ReferenceGenome::copy_bases(FastaIndexEntry const & contig,
+                                 uint64_t const begin,
+                                 uint64_t const end,
+                                 char * bases) const
+{
+    char const * data = static_cast<char const *>(mapping);
+    for (uint64_t position = begin; position < end;)
+    {
+        uint64_t const column = position % contig.line_bases;
+        uint64_t const amount = std::min(contig.line_bases - column, end - position);
+        std::memcpy(bases, data + contig.offset + position / contig.line_bases * contig.line_width + column, amount);
+        bases += amount;
+        position += amount;
+    }
+}
+
+ReferenceGenomeCache::Page const & ReferenceGenomeCache::get_page(uint64_t const index)
+{
+    ++amount_uses;
+    Page * least_recently_used = &pages.front();
+    for (Page & page : pages)
+    {
+        if (page.index == index)
+        {
+            page.last_use = amount_uses;
+            return page;
+        }
+        if (page.last_use < least_recently_used->last_use)
+            least_recently_used = &page;
+    }
+
+    uint64_t const begin = index * page_size;
+    uint64_t const end = std::min(begin + page_size, contig->length);
+    std::string characters(end - begin, 'N');
+    genome->copy_bases(*contig, begin, end, characters.data());
+
+    Page & page = *least_recently_used;
+    page.index = index;
+    page.last_use = amount_uses;
+    page.bases.resize(characters.size());
+    std::ranges::transform(characters, page.bases.begin(), [] (char const character)
+    {
+        return seqan3::assign_char_to(character, seqan3::dna5{});
+    });
+    return page;
+}
+
+void ReferenceGenomeCache::select_contig(InternedString const & name)
+{
+    if (name == contig_name)
+        return;
+
+    contig_name = name;
+    contig = genome->find(name);
+    for (Page & page : pages)
+    {
+        page.index = UINT64_MAX;
+        page.last_use = 0;
+    }
+}
+
+bool ReferenceGenomeCache::contains(InternedString const & name)
+{
+    select_contig(name);
+    return contig != nullptr;
+}
+
+void ReferenceGenomeCache::append_bases(InternedString const & name,
+                                        int64_t const begin,
+                                        int64_t const end,
+                                        seqan3::dna5_vector & sequence)
+{
+    select_contig(name);
+    int64_t const length = (contig == nullptr) ? 0 : static_cast<int64_t>(contig->length);
+    for (int64_t position = begin; position < end;)
+    {
+        // Positions in front of or behind the reference sequence are N.
+        if (position < 0 || position >= length)
+        {
+            int64_t const next_position = (position < 0) ? std::min<int64_t>(0, end) : end;
+            sequence.insert(sequence.end(), next_position - position, 'N'_dna5);
+            position = next_position;
+            continue;
+        }
+
+        Page const & page = get_page(position / page_size);
+        uint64_t const column = position % page_size;
+        uint64_t const amount = std::min<uint64_t>(page.bases.size() - column, end - position);
+        sequence.insert(sequence.end(), page.bases.begin() + column, page.bases.begin() + column + amount);
+        position += amount;
+    }
+}
@@ -0,0 +1,373 @@
+#include "variant_detection/bgzf_output.hpp"
+
+#include <zlib.h>       // for deflate and crc32
+
+#include <algorithm>    // for std::fill, std::max, std::min, std::ranges::find and std::ranges::find_if
+#include <array>        // for std::array
+#include <charconv>     // for std::from_chars
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::runtime_error
+#include <utility>      // for std::move
+
+namespace
+{
+
+//! \brief The end-of-file marker of BGZF files, an empty block.
+constexpr std::array<unsigned char, 28> bgzf_eof{0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+                                                 0x06, 0x00, 0x42, 0x43, 0x02, 0x00, 0x1b, 0x00, 0x03, 0x00,
+                                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+constexpr size_t bgzf_header_size = 18;
+constexpr size_t bgzf_footer_size = 8;
+
+//! \brief Appends an integer in little-endian byte order, as required by BGZF and the index formats.
+template <typename integer_t>
+void append_little_endian(std::string & out, integer_t const value)
+{
+    for (size_t i = 0; i < sizeof(integer_t); ++i)
+        out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xff));
+}
+
+//! \brief Compresses the text into a BGZF block, i.e. a gzip member with the block size in an extra field.
+std::string compress_block(std::vector<char> const & text)
+{
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error{"Could not initialise the BGZF compression."};
+
+    std::string block(bgzf_header_size + deflateBound(&stream, text.size()) + bgzf_footer_size, '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+    stream.avail_in = text.size();
+    stream.next_out = reinterpret_cast<Bytef *>(block.data() + bgzf_header_size);
+    stream.avail_out = block.size() - bgzf_header_size - bgzf_footer_size;
+    int const status = deflate(&stream, Z_FINISH);
+    size_t const compressed_size = stream.total_out;
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END)
+        throw std::runtime_error{"Could not compress a BGZF block."};
+
+    std::string header{};
+    header.append({'\x1f', '\x8b', '\x08', '\x04', '\0', '\0', '\0', '\0', '\0', '\xff', '\x06', '\0', 'B', 'C',
+                   '\x02', '\0'});
+    append_little_endian<uint16_t>(header, bgzf_header_size + compressed_size + bgzf_footer_size - 1);
+    block.replace(0, bgzf_header_size, header);
+    block.resize(bgzf_header_size + compressed_size);
+    append_little_endian<uint32_t>(block, crc32(crc32(0, nullptr, 0),
+                                                reinterpret_cast<Bytef const *>(text.data()),
+                                                text.size()));
+    append_little_endian<uint32_t>(block, text.size());
+    return block;
+}
+
+//! \brief The bin of the region [begin, end) in the binning scheme of htslib (hts_reg2bin).
+uint32_t region_to_bin(int64_t const begin, int64_t end, int32_t const min_shift, int32_t const depth)
+{
+    int32_t shift = min_shift;
+    int64_t first_bin = ((int64_t{1} << (3 * depth + 3)) - 1) / 7;
+    --end;
+    for (int32_t level = depth; level > 0; --level, shift += 3)
+    {
+        first_bin -= int64_t{1} << (3 * level);
+        if (begin >> shift == end >> shift)
+            return first_bin + (begin >> shift);
+    }
+    return 0;
+}
+
+//! \brief The first 16 kbp window of a bin (hts_bin_bot).
+uint64_t bin_first_window(uint32_t const bin, int32_t const depth)
+{
+    int32_t level = 0;
+    for (uint32_t b = bin; b != 0; b = (b - 1) >> 3)
+        ++level;
+    uint32_t const first_bin_of_level = ((uint32_t{1} << (3 * level)) - 1) / 7;
+    return static_cast<uint64_t>(bin - first_bin_of_level) << (3 * (depth - level));
+}
+
+} // namespace
+
+/* -------- VcfIndexBuilder -------- */
+
+VcfIndexBuilder::VcfIndexBuilder(int64_t const max_reference_length)
+{
+    // The same decision as htslib: the levels are added until the longest reference sequence fits.
+    int64_t const max_length = max_reference_length + 256;
+    int32_t levels = 0;
+    for (int64_t size = int64_t{1} << min_shift; max_length > size; size <<= 3)
+        ++levels;
+    csi = levels > 5;
+    depth = std::max(levels, 5);
+}
+
+std::string VcfIndexBuilder::get_extension() const
+{
+    return csi ? ".csi" : ".tbi";
+}
+
+bool VcfIndexBuilder::is_valid() const
+{
+    return sorted;
+}
+
+void VcfIndexBuilder::add_text(std::string_view text)
+{
+    while (!text.empty())
+    {
+        size_t const newline = text.find('\n');
+        if (newline == std::string_view::npos)
+        {
+            incomplete_line.append(text);
+            text_offset += text.size();
+            return;
+        }
+
+        uint64_t const line_begin = text_offset - incomplete_line.size();
+        text_offset += newline + 1;
+        if (incomplete_line.empty())
+        {
+            add_line(text.substr(0, newline), line_begin, text_offset);
+        }
+        else
+        {
+            incomplete_line.append(text.substr(0, newline));
+            add_line(incomplete_line, line_begin, text_offset);
+            incomplete_line.clear();
+        }
+        text.remove_prefix(newline + 1);
+    }
+}
+
+void VcfIndexBuilder::add_line(std::string_view const line, uint64_t const begin, uint64_t const end)
+{
+    if (line.empty() || line.front() == '#')
+        return;
+
+    // CHROM, POS, ID, REF, ALT, QUAL, FILTER and INFO
+    std::array<std::string_view, 8> fields{};
+    size_t field_begin = 0;
+    for (size_t i = 0; i < fields.size() && field_begin <= line.size(); ++i)
+    {
+        size_t const field_end = std::min(line.find('\t', field_begin), line.size());
+        fields[i] = line.substr(field_begin, field_end - field_begin);
+        field_begin = field_end + 1;
+    }
+
+    int64_t position = 0;
+    std::from_chars(fields[1].data(), fields[1].data() + fields[1].size(), position);
+    int64_t const region_begin = std::max<int64_t>(position - 1, 0);
+    int64_t region_end = region_begin + std::max<int64_t>(fields[3].size(), 1);
+    std::string_view const info = fields[7];
+    size_t end_field = info.starts_with("END=") ? 0 : info.find(";END=");
+    if (end_field != std::string_view::npos)
+    {
+        end_field += info.starts_with("END=") ? 4 : 5;
+        int64_t info_end = 0;
+        std::from_chars(info.data() + end_field, info.data() + info.size(), info_end);
+        region_end = std::max(region_end, info_end);
+    }
+
+    if (names.empty() || names.back() != fields[0])
+    {
+        if (std::ranges::find(names, fields[0]) != names.end())
+            sorted = false;
+        names.emplace_back(fields[0]);
+        references.emplace_back();
+    }
+    else if (region_begin < previous_begin)
+    {
+        sorted = false;
+    }
+    previous_begin = region_begin;
+    ReferenceIndex & reference = references.back();
+
+    std::vector<Chunk> & chunks = reference.bins[region_to_bin(region_begin, region_end, min_shift, depth)];
+    if (!chunks.empty() && chunks.back().end == begin)
+        chunks.back().end = end;
+    else
+        chunks.push_back(Chunk{begin, end});
+
+    uint64_t const last_window = (region_end - 1) >> min_shift;
+    if (reference.linear_index.size() <= last_window)
+        reference.linear_index.resize(last_window + 1, std::numeric_limits<uint64_t>::max());
+    for (uint64_t window = region_begin >> min_shift; window <= last_window; ++window)
+        reference.linear_index[window] = std::min(reference.linear_index[window], begin);
+}
+
+void VcfIndexBuilder::write(std::filesystem::path const & index_file_path,
+                            std::vector<uint64_t> const & block_offsets) const
+{
+    // The virtual file offset of a byte of the uncompressed text: the offset of its block in the compressed file in the
+    // upper 48 bits and its offset in the uncompressed block in the lower 16 bits.
+    auto virtual_offset = [&block_offsets] (uint64_t const offset)
+    {
+        return (block_offsets[offset / BgzfStreambuf::block_size] << 16) | (offset % BgzfStreambuf::block_size);
+    };
+
+    // Configuration of tabix for VCF files: format, column of the sequence name, begin and end, the comment character
+    // and the amount of skipped lines, followed by the names of the reference sequences.
+    std::string configuration{};
+    for (int32_t const value : {2, 1, 2, 0, static_cast<int32_t>('#'), 0})
+        append_little_endian<int32_t>(configuration, value);
+    std::string concatenated_names{};
+    for (std::string const & name : names)
+        concatenated_names.append(name).push_back('\0');
+    append_little_endian<int32_t>(configuration, concatenated_names.size());
+    configuration.append(concatenated_names);
+
+    std::string out{};
+    if (csi)
+    {
+        out.append("CSI\1");
+        append_little_endian<int32_t>(out, min_shift);
+        append_little_endian<int32_t>(out, depth);
+        append_little_endian<int32_t>(out, configuration.size());
+        out.append(configuration);
+        append_little_endian<int32_t>(out, references.size());
+    }
+    else
+    {
+        out.append("TBI\1");
+        append_little_endian<int32_t>(out, references.size());
+        out.append(configuration);
+    }
+
+    for (ReferenceIndex const & reference : references)
+    {
+        // Windows without records get the offset of the previous window, leading ones the offset of the first record.
+        std::vector<uint64_t> linear_index = reference.linear_index;
+        auto const first_record = std::ranges::find_if(linear_index, [] (uint64_t const offset)
+        {
+            return offset != std::numeric_limits<uint64_t>::max();
+        });
+        std::fill(linear_index.begin(), first_record, (first_record != linear_index.end()) ? *first_record : 0);
+        for (size_t window = 1; window < linear_index.size(); ++window)
+        {
+            if (linear_index[window] == std::numeric_limits<uint64_t>::max())
+                linear_index[window] = linear_index[window - 1];
+        }
+
+        append_little_endian<int32_t>(out, reference.bins.size());
+        for (auto const & [bin, chunks] : reference.bins)
+        {
+            append_little_endian<uint32_t>(out, bin);
+            if (csi) // the smallest offset of the records, which overlap the first window of the bin
+            {
+                uint64_t const window = bin_first_window(bin, depth);
+                append_little_endian<uint64_t>(out, (window < linear_index.size()) ? virtual_offset(linear_index[window])
+                                                                                   : 0);
+            }
+            append_little_endian<int32_t>(out, chunks.size());
+            for (Chunk const & chunk : chunks)
+            {
+                append_little_endian<uint64_t>(out, virtual_offset(chunk.begin));
+                append_little_endian<uint64_t>(out, virtual_offset(chunk.end));
+            }
+        }
+
+        if (!csi)
+        {
+            append_little_endian<int32_t>(out, linear_index.size());
+            for (uint64_t const offset : linear_index)
+                append_little_endian<uint64_t>(out, virtual_offset(offset));
+        }
+    }
+
+    BgzfStreambuf index_file{index_file_path, 1};
+    index_file.sputn(out.data(), out.size());
+    index_file.close();
+}
+
+/* -------- BgzfStreambuf -------- */
+
+BgzfStreambuf::BgzfStreambuf(std::filesystem::path const & file_path,
+                             size_t const threads,
+                             VcfIndexBuilder * index) :
+    file{file_path, std::ios_base::binary | std::ios_base::out},
+    buffer(block_size),
+    threads{std::max<size_t>(threads, 1)},
+    index{index}
+{
+    if (!file.is_open())
+        throw std::runtime_error{"Could not open file '" + file_path.string() + "' for writing."};
+    setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+BgzfStreambuf::~BgzfStreambuf()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // Errors can only be reported by calling close() explicitly.
+    }
+}
+
+BgzfStreambuf::int_type BgzfStreambuf::overflow(int_type const character)
+{
+    emit_block();
+    if (!traits_type::eq_int_type(character, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(character);
+        pbump(1);
+    }
+    return traits_type::not_eof(character);
+}
+
+void BgzfStreambuf::emit_block()
+{
+    size_t const size = pptr() - pbase();
+    if (size == 0)
+        return;
+
+    std::vector<char> text(buffer.begin(), buffer.begin() + size);
+    setp(buffer.data(), buffer.data() + buffer.size());
+    if (index != nullptr)
+        index->add_text(std::string_view{text.data(), text.size()});
+
+    if (threads == 1)
+    {
+        write_block(compress_block(text));
+        return;
+    }
+    // At most `threads` blocks are compressed at the same time, the oldest one is written first.
+    if (compressed_blocks.size() >= threads)
+        write_next_block();
+    compressed_blocks.push_back(std::async(std::launch::async, compress_block, std::move(text)));
+}
+
+void BgzfStreambuf::write_next_block()
+{
+    std::string const block = compressed_blocks.front().get();
+    compressed_blocks.pop_front();
+    write_block(block);
+}
+
+void BgzfStreambuf::write_block(std::string const & block)
+{
+    block_offsets.push_back(file_offset);
+    file.write(block.data(), block.size());
+    file_offset += block.size();
+}
+
+void BgzfStreambuf::close()
+{
+    if (closed)
+        return;
+    closed = true;
+
+    emit_block();
+    while (!compressed_blocks.empty())
+        write_next_block();
+    block_offsets.push_back(file_offset);
+    file.write(reinterpret_cast<char const *>(bgzf_eof.data()), bgzf_eof.size());
+    file.close();
+    if (!file)
+        throw std::runtime_error{"Could not write the compressed file."};
+}
+
+std::vector<uint64_t> const & BgzfStreambuf::get_block_offsets() const
+{
+    return block_offsets;
+}
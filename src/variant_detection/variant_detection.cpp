@@ -3,17 +3,25 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>                            // for std::ranges::find and std::ranges::sort
+#include <cassert>                              // for assert
+#include <filesystem>                           // for std::filesystem::path
+#include <future>                               // for std::async and std::future
+#include <limits>                               // for std::numeric_limits
+#include <memory>                               // for std::unique_ptr
+#include <tuple>                                // for std::tuple
+#include <utility>                              // for std::as_const
+
 #include <seqan3/core/debug_stream.hpp>
 #include <seqan3/io/sam_file/input.hpp>         // SAM/BAM support (seqan3::sam_file_input)
 
 #include "modules/sv_detection_methods/analyze_cigar_method.hpp"        // for the split read method
 #include "modules/sv_detection_methods/analyze_read_pair_method.hpp"    // for the read pair method
 #include "modules/sv_detection_methods/analyze_split_read_method.hpp"   // for the cigar string method
+#include "structures/junction_dump.hpp"                                 // for class JunctionSorter
+#include "structures/query_sequence.hpp"                                // for query_sequence_t
 #include "variant_detection/bam_functions.hpp"                          // for hasFlag* functions
 
-#include "cereal/types/memory.hpp"
-#include "cereal/types/vector.hpp"
-
 using seqan3::operator""_tag;
 
 // SAM fields for input file
@@ -26,6 +34,9 @@ using my_fields = seqan3::fields<seqan3::field::id,         // 1: QNAME
                                  seqan3::field::seq,        // 10:SEQ
                                  seqan3::field::tags>;
 
+// Alignment input file, which reads the SEQ field into a query_sequence_t.
+using alignment_input_t = seqan3::sam_file_input<alignment_file_traits, my_fields>;
+
 std::deque<std::string> read_header_information(auto & alignment_file,
                                                 std::map<std::string, int32_t> & references_lengths)
 {
@@ -74,34 +85,217 @@ void safe_sync_rename(std::filesystem::path const & tmp_file_path, std::filesyst
     std::filesystem::rename(tmp_file_path, file_path);
 }
 
-std::vector<std::unique_ptr<bamit::IntervalNode>> load_or_create_index(std::filesystem::path const & input_path)
+/*! \brief Checks whether an alignment record passes the filters of the junction detection. Only the fixed-size fields
+ *         FLAG, RNAME, POS and MAPQ are inspected, such that the variable-length fields of discarded records are never
+ *         touched.
+ *
+ * \param[in] record - the alignment record
+ *
+ * \returns Whether the alignment is mapped, primary, no duplicate and has a mapping quality of at least 20.
+ */
+template <typename record_t>
+bool is_good_alignment(record_t const & record)
+{
+    seqan3::sam_flag const flag = record.flag();
+    return !hasFlagUnmapped(flag) && !hasFlagSecondary(flag) && !hasFlagDuplicate(flag) &&
+           record.mapping_quality() >= 20 &&
+           record.reference_id().value_or(-1) >= 0 && record.reference_position().value_or(-1) >= 0;
+}
+
+/*! \brief Computes the number of reference bases covered by an alignment.
+ *
+ * \param[in] cigar - the CIGAR string of the alignment
+ *
+ * \returns The length of the aligned reference interval.
+ */
+int32_t get_reference_span(std::vector<seqan3::cigar> const & cigar)
 {
-    std::filesystem::path bamit_index_file_path{input_path};
-    bamit_index_file_path += ".bit";
-    std::vector<std::unique_ptr<bamit::IntervalNode>> node_list{};
-    if (std::filesystem::exists(bamit_index_file_path))
+    using seqan3::operator""_cigar_operation;
+    using seqan3::get;
+
+    int32_t span = 0;
+    for (seqan3::cigar const & pair : cigar)
     {
-        std::ifstream in{bamit_index_file_path, std::ios_base::binary | std::ios_base::in};
-        cereal::BinaryInputArchive ar(in);
-        bamit::read(node_list, ar);
-        in.close();
+        seqan3::cigar::operation const operation = get<1>(pair);
+        if (operation == 'M'_cigar_operation || operation == 'D'_cigar_operation || operation == 'N'_cigar_operation ||
+            operation == '='_cigar_operation || operation == 'X'_cigar_operation)
+        {
+            span += get<0>(pair);
+        }
     }
-    else
+    return span;
+}
+
+/*! \brief Adds an alignment record to an alignment index, if it has a reference position.
+ *
+ * \param[in, out]  index_builder - the alignment index builder
+ * \param[in]       record - the alignment record
+ * \param[in]       file_position - the position of the record in the alignment file
+ */
+template <typename record_t>
+void add_to_index(AlignmentIndexBuilder & index_builder, record_t const & record, std::streamoff const file_position)
+{
+    int32_t const ref_id = record.reference_id().value_or(-1);
+    int32_t const ref_pos = record.reference_position().value_or(-1);
+    if (ref_id < 0 || ref_pos < 0)
+        return;
+
+    // An alignment covers at least one reference base, such that it is found by the region queries.
+    int32_t const ref_end = ref_pos + std::max(get_reference_span(record.cigar_sequence()), 1);
+    index_builder.add(ref_id, ref_pos, ref_end, file_position);
+}
+
+/*! \brief Writes an alignment index next to the alignment file, with ".igvi" appended at the end of its name.
+ *
+ * \param[in] index_builder - the alignment index builder
+ * \param[in] input_path - the path to the short/long read alignment file
+ */
+void write_index(AlignmentIndexBuilder const & index_builder, std::filesystem::path const & input_path)
+{
+    std::filesystem::path index_file_path{input_path};
+    index_file_path += ".igvi";
+    std::filesystem::path index_file_tmp_path{input_path};
+    index_file_tmp_path += ".igvi.tmp";
+    index_builder.write(index_file_tmp_path);
+    // If a run of iGenVar is aborted during the index creation, an incorrect index is stored, which cannot be read when
+    // iGenVar is called again. Therefore, we write the index to a tmp file and save it with the correct file name
+    // when finished.
+    safe_sync_rename(index_file_tmp_path, index_file_path);
+}
+
+AlignmentIndex load_or_create_index(std::filesystem::path const & input_path)
+{
+    std::filesystem::path index_file_path{input_path};
+    index_file_path += ".igvi";
+    if (std::filesystem::exists(index_file_path))
     {
-        std::filesystem::path bamit_index_file_tmp_path{input_path};
-        bamit_index_file_tmp_path += ".bit.tmp";
-        std::ofstream out{bamit_index_file_tmp_path, std::ios_base::binary | std::ios_base::out};
-        cereal::BinaryOutputArchive ar(out);
-        seqan3::sam_file_input input_sam{input_path, my_fields{}};
-        node_list = bamit::index(input_sam);
-        bamit::write(node_list, ar);
-        out.close();
-        // If a run of iGenVar is aborted during BAMIT creation, an incorrect index is stored, which cannot be read when
-        // iGenVar is called again. Therefore, we write the index to a tmp file and save it with the correct file name
-        // when finished.
-        safe_sync_rename(bamit_index_file_tmp_path, bamit_index_file_path);
+        try
+        {
+            return AlignmentIndex{index_file_path};
+        }
+        catch (std::runtime_error const & ext)
+        {
+            seqan3::debug_stream << "Warning: " << ext.what() << " It is created again.\n";
+        }
+    }
+
+    // Only the fields describing the reference interval of an alignment are needed.
+    using index_fields = seqan3::fields<seqan3::field::ref_id, seqan3::field::ref_offset, seqan3::field::cigar>;
+    seqan3::sam_file_input input_sam{input_path, index_fields{}};
+    AlignmentIndexBuilder index_builder{input_sam.header().ref_ids().size()};
+    for (auto it = input_sam.begin(); it != input_sam.end(); ++it)
+        add_to_index(index_builder, *it, it.file_position());
+    write_index(index_builder, input_path);
+    return AlignmentIndex{index_file_path};
+}
+
+std::vector<GenomicRegion> get_regions(cmd_arguments const & args)
+{
+    std::vector<GenomicRegion> regions{};
+    for (std::string const & region : args.regions)
+        regions.push_back(parse_region(region));
+    if (!args.regions_bed_file_path.empty())
+    {
+        std::vector<GenomicRegion> bed_regions = read_regions_bed(args.regions_bed_file_path);
+        regions.insert(regions.end(), bed_regions.begin(), bed_regions.end());
+    }
+    return regions;
+}
+
+/*! \brief Calls `process_record` for the alignment records of a file in the order of the file. If regions are given,
+ *         only the records overlapping a region are visited.
+ *
+ * \param[in, out]  alignment_file - the alignment input file (the header has already been read)
+ * \param[in]       ref_ids - the reference sequence names parsed from the header
+ * \param[in]       regions - the regions to restrict the records to, all records are visited if it is empty
+ * \param[in]       alignment_index - the index of the alignment file, only used if regions are given
+ * \param[in, out]  index_builder - if not null, all records are added to it (only supported without regions)
+ * \param[in]       process_record - called with each visited record
+ *
+ * \details The regions are sorted by the order of the reference sequences in the header and overlapping regions are
+ *          merged. For each region, the alignment index is queried for the file position of the first overlapping record
+ *          and the file is read from there until the records start behind the region. A record overlapping two
+ *          regions is only visited for the first one. Regions on reference sequences that are missing in the header
+ *          are skipped with a warning.
+ */
+template <typename alignment_file_t, typename process_record_t>
+void for_each_alignment(alignment_file_t & alignment_file,
+                        std::deque<std::string> const & ref_ids,
+                        std::vector<GenomicRegion> const & regions,
+                        AlignmentIndex const & alignment_index,
+                        AlignmentIndexBuilder * const index_builder,
+                        process_record_t && process_record)
+{
+    if (regions.empty())
+    {
+        for (auto it = alignment_file.begin(); it != alignment_file.end(); ++it)
+        {
+            if (index_builder != nullptr)
+                add_to_index(*index_builder, *it, it.file_position());
+            process_record(*it);
+        }
+        return;
+    }
+    assert(index_builder == nullptr);
+
+    // Intervals (ref_id, start, end) in the order of the file.
+    std::vector<std::tuple<int32_t, int32_t, int32_t>> intervals{};
+    for (GenomicRegion const & region : regions)
+    {
+        auto const ref_id_it = std::ranges::find(ref_ids, region.seq_name);
+        if (ref_id_it == ref_ids.end())
+        {
+            seqan3::debug_stream << "Warning: The region " << region << " is on a reference sequence that is missing"
+                                 << " in the alignment file and is skipped.\n";
+            continue;
+        }
+        intervals.emplace_back(std::distance(ref_ids.begin(), ref_id_it), region.start, region.end);
+    }
+    std::ranges::sort(intervals);
+
+    std::vector<std::tuple<int32_t, int32_t, int32_t>> merged_intervals{};
+    for (auto const & [ref_id, start, end] : intervals)
+    {
+        if (!merged_intervals.empty() && std::get<0>(merged_intervals.back()) == ref_id &&
+            std::get<2>(merged_intervals.back()) >= start)
+        {
+            std::get<2>(merged_intervals.back()) = std::max(std::get<2>(merged_intervals.back()), end);
+        }
+        else
+        {
+            merged_intervals.emplace_back(ref_id, start, end);
+        }
+    }
+
+    for (size_t i = 0; i < merged_intervals.size(); ++i)
+    {
+        auto const [ref_id, start, end] = merged_intervals[i];
+        // The records overlapping the previous region on the same reference sequence have already been visited.
+        int32_t const visited_until = (i > 0 && std::get<0>(merged_intervals[i - 1]) == ref_id)
+                                    ? std::get<2>(merged_intervals[i - 1])
+                                    : std::numeric_limits<int32_t>::min();
+
+        std::streamoff const file_position = alignment_index.first_overlap(ref_id, start, end);
+        if (file_position < 0) // no overlapping record
+            continue;
+        alignment_file.seek_to(file_position);
+
+        for (auto & record : alignment_file)
+        {
+            int32_t const record_ref_id = record.reference_id().value_or(-1);
+            int32_t const record_pos = record.reference_position().value_or(-1);
+            // Unmapped reads are sorted to the end of the file.
+            if (record_ref_id > ref_id || record_ref_id < 0 || record_pos >= end)
+                break;
+
+            // A record that starts before the end of the previous region overlaps the previous region as well.
+            if (record_ref_id == ref_id && record_pos >= visited_until &&
+                record_pos + get_reference_span(record.cigar_sequence()) > start)
+            {
+                process_record(record);
+            }
+        }
     }
-    return node_list;
 }
 
 void detect_junctions_in_short_reads_sam_file([[maybe_unused]] std::vector<Junction> & junctions,
@@ -109,28 +303,37 @@ void detect_junctions_in_short_reads_sam_file([[maybe_unused]] std::vector<Junct
                                               cmd_arguments const & args)
 {
     // Open input alignment file
-    seqan3::sam_file_input alignment_short_reads_file{args.alignment_short_reads_file_path, my_fields{}};
+    alignment_input_t alignment_short_reads_file{args.alignment_short_reads_file_path};
 
     std::deque<std::string> const ref_ids = read_header_information(alignment_short_reads_file, references_lengths);
     uint32_t num_good = 0;
 
-    // Load bamit index, or create index if it doesn't exist.
-    std::vector<std::unique_ptr<bamit::IntervalNode>> bamit_index = load_or_create_index(args.alignment_short_reads_file_path);
+    // Load the alignment index, if it exists. Otherwise, the index is built from the records read for the detection
+    // and written at the end, unless it is needed beforehand to seek to the given regions.
+    std::vector<GenomicRegion> const regions = get_regions(args);
+    std::filesystem::path index_file_path{args.alignment_short_reads_file_path};
+    index_file_path += ".igvi";
+    AlignmentIndex alignment_index{};
+    std::unique_ptr<AlignmentIndexBuilder> index_builder{};
+    if (!regions.empty() || std::filesystem::exists(index_file_path))
+        alignment_index = load_or_create_index(args.alignment_short_reads_file_path);
+    else
+        index_builder = std::make_unique<AlignmentIndexBuilder>(ref_ids.size());
 
-    for (auto & record : alignment_short_reads_file)
+    for_each_alignment(alignment_short_reads_file, ref_ids, regions, alignment_index, index_builder.get(),
+                       [&] (auto & record)
     {
-        std::string const query_name        = record.id();                              // 1: QNAME
-        seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
-        int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
-        int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
-        uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
-        std::vector<seqan3::cigar> cigar    = record.cigar_sequence();                  // 6: CIGAR
-        seqan3::dna5_vector const seq       = record.sequence();                        // 10:SEQ
-        auto tags                           = record.tags();
-
-        if (hasFlagUnmapped(flag) || hasFlagSecondary(flag) || hasFlagDuplicate(flag) || mapq < 20 ||
-            ref_id < 0 || ref_pos < 0)
-            continue;
+        if (!is_good_alignment(record))
+            return;
+
+        // The fields are only referenced, not copied.
+        std::string const & query_name              = record.id();                          // 1: QNAME
+        seqan3::sam_flag const flag                 = record.flag();                        // 2: FLAG
+        int32_t const ref_id                        = record.reference_id().value();        // 3: RNAME
+        int32_t const ref_pos                       = record.reference_position().value();  // 4: POS
+        uint8_t const mapq                          = record.mapping_quality();             // 5: MAPQ
+        std::vector<seqan3::cigar> const & cigar    = record.cigar_sequence();              // 6: CIGAR
+        query_sequence_t const & seq                = record.sequence();                    // 10:SEQ
 
         std::string const & ref_name = ref_ids[ref_id];
 
@@ -147,9 +350,10 @@ void detect_junctions_in_short_reads_sam_file([[maybe_unused]] std::vector<Junct
                                   args.min_var_length);
                     break;
                 case detection_methods::split_read:     // Detect junctions from split read evidence (SA tag,
-                    if (!hasFlagSupplementary(flag))    //                                  primary alignments only)
+                    if (!hasFlagSupplementary(flag) &&     //                                  primary alignments only)
+                        record.tags().contains("SA"_tag))
                     {
-                        std::string const sa_tag = tags.get<"SA"_tag>();
+                        std::string const & sa_tag = std::as_const(record.tags()).get<"SA"_tag>();
                         if (!sa_tag.empty())
                         {
                             analyze_sa_tag(query_name,
@@ -184,7 +388,165 @@ void detect_junctions_in_short_reads_sam_file([[maybe_unused]] std::vector<Junct
                 seqan3::debug_stream << num_good << " good alignments from short read file." << std::endl;
             }
         }
+    });
+
+    if (index_builder)
+        write_index(*index_builder, args.alignment_short_reads_file_path);
+}
+
+/*! \brief Detects junctions in a single long read alignment record.
+ *
+ * \param[in]       record - the alignment record
+ * \param[in]       ref_ids - the reference sequence names parsed from the header
+ * \param[in]       args - command line arguments
+ * \param[in, out]  junctions - a vector of junctions
+ *
+ * \returns Whether the alignment passed the filters (mapped, primary, no duplicate, high mapping quality).
+ */
+template <typename record_t>
+bool analyze_long_read_alignment(record_t & record,
+                                 std::deque<std::string> const & ref_ids,
+                                 cmd_arguments const & args,
+                                 std::vector<Junction> & junctions)
+{
+    if (!is_good_alignment(record))
+        return false;
+
+    // The fields are only referenced, not copied.
+    std::string const & query_name              = record.id();                          // 1: QNAME
+    seqan3::sam_flag const flag                 = record.flag();                        // 2: FLAG
+    int32_t const ref_id                        = record.reference_id().value();        // 3: RNAME
+    int32_t const ref_pos                       = record.reference_position().value();  // 4: POS
+    uint8_t const mapq                          = record.mapping_quality();             // 5: MAPQ
+    std::vector<seqan3::cigar> const & cigar    = record.cigar_sequence();              // 6: CIGAR
+    query_sequence_t const & seq                = record.sequence();                    // 10:SEQ
+
+    std::string const & ref_name = ref_ids[ref_id];
+
+    for (detection_methods method : args.methods) {
+        switch (method)
+        {
+            case detection_methods::cigar_string: // Detect junctions from CIGAR string
+                analyze_cigar(query_name,
+                              ref_name,
+                              ref_pos,
+                              cigar,
+                              seq,
+                              junctions,
+                              args.min_var_length);
+                break;
+            case detection_methods::split_read:     // Detect junctions from split read evidence (SA tag,
+                if (!hasFlagSupplementary(flag) &&     //                                  primary alignments only)
+                    record.tags().contains("SA"_tag))
+                {
+                    std::string const & sa_tag = std::as_const(record.tags()).template get<"SA"_tag>();
+                    if (!sa_tag.empty())
+                    {
+                        analyze_sa_tag(query_name,
+                                       flag,
+                                       ref_name,
+                                       ref_pos,
+                                       mapq,
+                                       cigar,
+                                       seq,
+                                       sa_tag,
+                                       args,
+                                       junctions);
+                    }
+                }
+                break;
+            case detection_methods::read_pairs:
+                // There are no read pairs in long reads.
+                break;
+            case detection_methods::read_depth: // Detect junctions from read depth evidence
+                // Not yet implemented, see report_unimplemented_long_read_methods().
+                break;
+        }
     }
+    return true;
+}
+
+//! \brief Reports the selected detection methods, which are not implemented for long reads, once per file.
+void report_unimplemented_long_read_methods(cmd_arguments const & args)
+{
+    if (std::ranges::find(args.methods, detection_methods::read_depth) != args.methods.end())
+        seqan3::debug_stream << "The read depth method for long reads is not yet implemented.\n";
+}
+
+/*! \brief Detects junctions in the long read alignments of a file using `args.threads` worker threads.
+ *
+ * \param[in, out]  alignment_file - the long read input file (the header has already been read)
+ * \param[in]       ref_ids - the reference sequence names parsed from the header
+ * \param[in]       regions - the regions to restrict the alignments to, see for_each_alignment()
+ * \param[in]       alignment_index - the index of the alignment file, only used if regions are given
+ * \param[in]       args - command line arguments
+ * \param[in, out]  junctions - a vector of junctions
+ *
+ * \details The alignment records are split into tasks along the reference sequences of the \@SQ dictionary: a task
+ *          holds the consecutive records of a single reference sequence (at most `max_records_per_task`) and is
+ *          analysed by a worker thread into its own junction vector. The junction vectors are appended to `junctions`
+ *          in the order of the tasks, such that the result is identical to a sequential analysis of the file.
+ *          The number of pending tasks is limited to `args.threads`, which bounds the memory consumption.
+ */
+template <typename alignment_file_t>
+void analyze_long_read_alignments_in_parallel(alignment_file_t & alignment_file,
+                                              std::deque<std::string> const & ref_ids,
+                                              std::vector<GenomicRegion> const & regions,
+                                              AlignmentIndex const & alignment_index,
+                                              cmd_arguments const & args,
+                                              std::vector<Junction> & junctions)
+{
+    using record_t = typename alignment_file_t::record_type;
+    constexpr size_t max_records_per_task = 10000;
+
+    std::deque<std::future<std::vector<Junction>>> tasks{};
+    std::vector<record_t> records{};
+    int32_t current_ref_id = -1;
+
+    // Append the junctions of the oldest task, this keeps the order of the input file.
+    auto collect_oldest_task = [&] ()
+    {
+        std::vector<Junction> task_junctions = tasks.front().get();
+        tasks.pop_front();
+        junctions.insert(junctions.end(),
+                         std::make_move_iterator(task_junctions.begin()),
+                         std::make_move_iterator(task_junctions.end()));
+    };
+
+    auto submit_task = [&] ()
+    {
+        if (records.empty())
+            return;
+
+        tasks.push_back(std::async(std::launch::async,
+                                   [&ref_ids, &args, task_records = std::move(records)] () mutable
+                                   {
+                                       std::vector<Junction> task_junctions{};
+                                       for (record_t & record : task_records)
+                                           analyze_long_read_alignment(record, ref_ids, args, task_junctions);
+                                       return task_junctions;
+                                   }));
+        records = std::vector<record_t>{};
+
+        if (tasks.size() >= args.threads)
+            collect_oldest_task();
+    };
+
+    for_each_alignment(alignment_file, ref_ids, regions, alignment_index, nullptr, [&] (auto & record)
+    {
+        int32_t const ref_id = record.reference_id().value_or(-1);
+        // A task never spans two reference sequences.
+        if (ref_id != current_ref_id || records.size() == max_records_per_task)
+        {
+            submit_task();
+            current_ref_id = ref_id;
+        }
+        records.push_back(std::move(record));
+    });
+    submit_task();
+
+    while (!tasks.empty())
+        collect_oldest_task();
 }
 
 void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
@@ -192,67 +554,83 @@ void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
                                              cmd_arguments const & args)
 {
     // Open input alignment file
-    seqan3::sam_file_input alignment_long_reads_file{args.alignment_long_reads_file_path, my_fields{}};
+    alignment_input_t alignment_long_reads_file{args.alignment_long_reads_file_path};
 
     std::deque<std::string> const ref_ids = read_header_information(alignment_long_reads_file, references_lengths);
-    uint32_t num_good = 0;
+    report_unimplemented_long_read_methods(args);
+
+    // The alignment index is only needed to seek to the given regions.
+    std::vector<GenomicRegion> const regions = get_regions(args);
+    AlignmentIndex alignment_index{};
+    if (!regions.empty())
+        alignment_index = load_or_create_index(args.alignment_long_reads_file_path);
 
-    for (auto & record : alignment_long_reads_file)
+    // In verbose mode, each junction is logged as soon as it is found. Keep the analysis sequential in this case, such
+    // that the log stays readable.
+    if (args.threads > 1 && !gVerbose)
     {
-        std::string const query_name        = record.id();                              // 1: QNAME
-        seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
-        int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
-        int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
-        uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
-        std::vector<seqan3::cigar> cigar    = record.cigar_sequence();                  // 6: CIGAR
-        seqan3::dna5_vector const seq       = record.sequence();                        // 10:SEQ
-        auto tags                           = record.tags();
-
-        if (hasFlagUnmapped(flag) || hasFlagSecondary(flag) || hasFlagDuplicate(flag) || mapq < 20 ||
-            ref_id < 0 || ref_pos < 0)
-            continue;
+        analyze_long_read_alignments_in_parallel(alignment_long_reads_file,
+                                                 ref_ids,
+                                                 regions,
+                                                 alignment_index,
+                                                 args,
+                                                 junctions);
+        return;
+    }
 
-        std::string const & ref_name = ref_ids[ref_id];
+    uint32_t num_good = 0;
 
-        for (detection_methods method : args.methods) {
-            switch (method)
+    for_each_alignment(alignment_long_reads_file, ref_ids, regions, alignment_index, nullptr, [&] (auto & record)
+    {
+        if (!analyze_long_read_alignment(record, ref_ids, args, junctions))
+            return;
+
+        if (gVerbose)
+        {
+            ++num_good;
+            if (num_good % 100000 == 0)
             {
-                case detection_methods::cigar_string: // Detect junctions from CIGAR string
-                    analyze_cigar(query_name,
-                                  ref_name,
-                                  ref_pos,
-                                  cigar,
-                                  seq,
-                                  junctions,
-                                  args.min_var_length);
-                    break;
-                case detection_methods::split_read:     // Detect junctions from split read evidence (SA tag,
-                    if (!hasFlagSupplementary(flag))    //                                  primary alignments only)
-                    {
-                        std::string const sa_tag = tags.get<"SA"_tag>();
-                        if (!sa_tag.empty())
-                        {
-                            analyze_sa_tag(query_name,
-                                           flag,
-                                           ref_name,
-                                           ref_pos,
-                                           mapq,
-                                           cigar,
-                                           seq,
-                                           sa_tag,
-                                           args,
-                                           junctions);
-                        }
-                    }
-                    break;
-                case detection_methods::read_pairs:
-                    // There are no read pairs in long reads.
-                    break;
-                case detection_methods::read_depth: // Detect junctions from read depth evidence
-                    seqan3::debug_stream << "The read depth method for long reads is not yet implemented.\n";
-                    break;
+                seqan3::debug_stream << num_good << " good alignments from long read file." << std::endl;
             }
         }
+    });
+}
+
+void stream_junctions_in_long_reads_sam_file(std::map<std::string, int32_t> & references_lengths,
+                                             cmd_arguments const & args,
+                                             std::function<void()> const & header_read,
+                                             std::function<void(std::vector<Junction> &)> const & process_batch)
+{
+    // Open input alignment file
+    alignment_input_t alignment_long_reads_file{args.alignment_long_reads_file_path};
+
+    std::deque<std::string> const ref_ids = read_header_information(alignment_long_reads_file, references_lengths);
+    header_read();
+    report_unimplemented_long_read_methods(args);
+
+    // The alignment index is only needed to seek to the given regions.
+    std::vector<GenomicRegion> const regions = get_regions(args);
+    AlignmentIndex alignment_index{};
+    if (!regions.empty())
+        alignment_index = load_or_create_index(args.alignment_long_reads_file_path);
+
+    // The junctions are sorted in runs of this size, which bounds the memory of the detection.
+    constexpr size_t junctions_per_run = 1000000;
+    // The sorted junctions are handed over in batches of whole partitions with at least this many junctions.
+    constexpr size_t junctions_per_batch = 100000;
+
+    JunctionSorter sorter{references_lengths, junctions_per_run};
+    std::vector<Junction> record_junctions{};   // the junctions of the current alignment
+    uint32_t num_good = 0;
+
+    for_each_alignment(alignment_long_reads_file, ref_ids, regions, alignment_index, nullptr, [&] (auto & record)
+    {
+        record_junctions.clear();
+        if (!analyze_long_read_alignment(record, ref_ids, args, record_junctions))
+            return;
+
+        for (Junction & junction : record_junctions)
+            sorter.add(std::move(junction));
 
         if (gVerbose)
         {
@@ -262,5 +640,9 @@ void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
                 seqan3::debug_stream << num_good << " good alignments from long read file." << std::endl;
             }
         }
-    }
+    });
+
+    // The split reads of an alignment can add junctions on any reference sequence, thus the junctions of a reference
+    // sequence are only complete after the whole file has been read.
+    sorter.merge(static_cast<int32_t>(args.partition_max_distance), junctions_per_batch, process_batch);
 }
@@ -1,9 +1,15 @@
 #include "variant_detection/variant_output.hpp"
 
-#include <chrono>   // for std::chrono::system_clock
-#include <ctime>    // for std::localtime, std::time, std::time_t
-#include <iomanip>  // for std::put_time
-#include <iostream> // for std::cout
+#include <algorithm>            // for std::max and std::min
+#include <chrono>               // for std::chrono::system_clock
+#include <condition_variable>   // for std::condition_variable
+#include <ctime>                // for std::localtime, std::time, std::time_t
+#include <exception>            // for std::exception_ptr, std::current_exception and std::rethrow_exception
+#include <future>               // for std::async and std::future
+#include <iomanip>              // for std::put_time
+#include <iostream>             // for std::cout
+#include <mutex>                // for std::mutex, std::lock_guard and std::unique_lock
+#include <span>                 // for std::span
 
 #include <seqan3/core/debug_stream.hpp> // for seqan3::debug_stream
 
@@ -51,18 +57,18 @@ void write_header(std::map<std::string, int32_t> & references_lengths,
 
 void write_record(Cluster const & cluster,
                   cmd_arguments const & args,
+                  std::optional<ReferenceGenomeCache> & reference_cache,
                   bool & found_SV,
                   bio::var_io::default_record<> & record)
 {
-    Breakend mate1 = cluster.get_average_mate1();
-    Breakend mate2 = cluster.get_average_mate2();
+    Breakend const & mate1 = cluster.get_average_mate1();
+    Breakend const & mate2 = cluster.get_average_mate2();
 
     record.chrom() = mate1.seq_name;
     // Increment position by 1 because VCF is 1-based
     record.pos() = mate1.position + 1;
     // TODO (irallia 23.02.22): add global RECORD_ID
     record.id() = ".";
-    // TODO (irallia 23.02.22): add reference
     record.ref() = "N"_dna5;
     record.qual() = cluster.get_cluster_size();
     record.filter() = {"PASS"};
@@ -140,41 +146,276 @@ void write_record(Cluster const & cluster,
                 record.info().push_back({.id = "iGenVar_SVLEN", .value = sv_length_iGenVar});
                 record.info().push_back({.id = "SVTYPE", .value = sv_type});
                 found_SV = true;
+
+                // Without the reference sequence, REF stays N and a deletion keeps its symbolic ALT.
+                if (reference_cache && reference_cache->contains(mate1.seq_name))
+                {
+                    // The REF column holds the base at POS and for a deletion also the deleted bases up to END.
+                    int64_t const ref_begin = record.pos() - 1;
+                    int64_t const ref_end = (sv_type == "DEL") ? mate2.position : ref_begin + 1;
+                    record.ref().clear();
+                    reference_cache->append_bases(mate1.seq_name, ref_begin, ref_end, record.ref());
+                    if (sv_type == "DEL")
+                        record.alt() = {std::string{seqan3::to_char(record.ref().front())}};
+                }
             }
         }
     }
 }
 
-void find_and_output_variants(std::map<std::string, int32_t> & references_lengths,
-                              std::vector<Cluster> const & clusters,
-                              cmd_arguments const & args,
-                              std::filesystem::path const & output_file_path)
+VariantWriter::VariantWriter(std::map<std::string, int32_t> & references_lengths,
+                             cmd_arguments const & args,
+                             std::filesystem::path const & output_file_path) :
+    output_file_path{output_file_path}
 {
     bio::var_io::header hdr{};
     write_header(references_lengths, args.vcf_sample_name, hdr);
 
-    bio::var_io::default_record<> record{};
-    size_t amount_SVs = 0;
-    bool found_SV = false;
+    if (!args.genome_file_path.empty())
+    {
+        genome = std::make_unique<ReferenceGenome>(args.genome_file_path);
+        for (auto const & [id, length] : references_lengths)
+        {
+            if (genome->find(id) == nullptr)
+            {
+                seqan3::debug_stream << "Warning: The reference sequence " << id << " is missing in the reference "
+                                     << "genome " << args.genome_file_path.string() << ", thus its REF column is N.\n";
+            }
+        }
+    }
+
+    if (output_file_path.extension() == ".gz")
+    {
+        int32_t max_reference_length = 0;
+        for (auto const & [id, length] : references_lengths)
+            max_reference_length = std::max(max_reference_length, length);
+
+        index = std::make_unique<VcfIndexBuilder>(max_reference_length);
+        compressed_buffer = std::make_unique<BgzfStreambuf>(output_file_path, args.threads, index.get());
+        compressed_stream = std::make_unique<std::ostream>(compressed_buffer.get());
+        writer.emplace(*compressed_stream, bio::vcf{});
+    }
+    else if (output_file_path.empty())
+    {
+        writer.emplace(std::cout, bio::vcf{});
+    }
+    else
+    {
+        // The writer selects VCF or BCF by the file extension.
+        writer.emplace(output_file_path);
+    }
+
+    writer->set_header(hdr);
+}
+
+VariantWriter::~VariantWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        // Errors can only be reported by calling close() explicitly.
+    }
+}
 
-    auto writer
-        = output_file_path.empty() ? bio::var_io::writer{std::cout, bio::vcf{}} : bio::var_io::writer{output_file_path};
+bio::var_io::writer<> & VariantWriter::get_writer()
+{
+    return *writer;
+}
 
-    writer.set_header(hdr);
-    for (size_t i = 0; i < clusters.size(); ++i)
+void VariantWriter::close()
+{
+    // Destroying the writer writes the header, if there are no records, and flushes the records.
+    writer.reset();
+    if (compressed_buffer != nullptr)
+    {
+        // Released first, such that the index is not written after an error.
+        std::unique_ptr<BgzfStreambuf> const buffer = std::move(compressed_buffer);
+        buffer->close();
+        if (index->is_valid())
+        {
+            index->write(output_file_path.string() + index->get_extension(), buffer->get_block_offsets());
+        }
+        else
+        {
+            seqan3::debug_stream << "Warning: The records in " << output_file_path.string() << " are not sorted by "
+                                 << "their reference sequence and position, thus no index is written.\n";
+        }
+    }
+}
+
+// The amount of clusters, which are formatted by one thread at a time.
+constexpr size_t clusters_per_chunk = 4096;
+
+/*! \brief Detects the genomic variants of a chunk of clusters.
+ *
+ * \param[in] clusters             - the clusters of the chunk
+ * \param[in] args                 - command line arguments, see find_and_output_variants()
+ * \param[in, out] reference_cache - cache of the reference genome of the thread, see write_record()
+ * \param[out] records             - the records of the detected SVs in the order of the clusters
+ */
+void format_records(std::span<Cluster const> const clusters,
+                    cmd_arguments const & args,
+                    std::optional<ReferenceGenomeCache> & reference_cache,
+                    std::vector<bio::var_io::default_record<>> & records)
+{
+    records.clear();
+    for (Cluster const & cluster : clusters)
     {
         // ignore low quality SVs
-        if (clusters[i].get_cluster_size() >= args.min_qual)
+        if (cluster.get_cluster_size() >= args.min_qual)
+        {
+            bool found_SV = false;
+            write_record(cluster, args, reference_cache, found_SV, records.emplace_back());
+            if (!found_SV)
+                records.pop_back();
+        }
+    }
+}
+
+size_t output_variants(std::vector<Cluster> const & clusters,
+                       cmd_arguments const & args,
+                       VariantWriter & writer)
+{
+    size_t const amount_chunks = (clusters.size() + clusters_per_chunk - 1) / clusters_per_chunk;
+    auto chunk = [&] (size_t const index)
+    {
+        return std::span<Cluster const>{clusters}.subspan(index * clusters_per_chunk,
+                                                          std::min(clusters_per_chunk,
+                                                                   clusters.size() - index * clusters_per_chunk));
+    };
+
+    // A cache is not thread-safe, thus every thread opens its own cache.
+    auto open_reference_cache = [&] ()
+    {
+        std::optional<ReferenceGenomeCache> reference_cache{};
+        if (writer.get_genome() != nullptr)
+            reference_cache.emplace(*writer.get_genome());
+        return reference_cache;
+    };
+
+    size_t amount_SVs = 0;
+    std::vector<bio::var_io::default_record<>> records{};
+    size_t const amount_threads = std::min<size_t>(args.threads, amount_chunks);
+    if (amount_threads <= 1)
+    {
+        std::optional<ReferenceGenomeCache> reference_cache = open_reference_cache();
+        for (size_t index = 0; index < amount_chunks; ++index)
+        {
+            format_records(chunk(index), args, reference_cache, records);
+            for (bio::var_io::default_record<> const & record : records)
+                writer.get_writer().push_back(record);
+            amount_SVs += records.size();
+        }
+        return amount_SVs;
+    }
+
+    // The chunks are formatted concurrently, while this thread writes them in their original order. A chunk is
+    // formatted only if it fits into the reorder buffer, i.e. if it is at most `window` chunks ahead of the writer.
+    size_t const window = 2 * amount_threads;
+    std::vector<std::vector<bio::var_io::default_record<>>> buffer(window);
+    std::vector<bool> formatted(window, false);
+    size_t next_chunk = 0;
+    size_t next_written_chunk = 0;
+    std::mutex mutex{};
+    std::condition_variable chunk_formatted{};
+    std::condition_variable chunk_written{};
+    // The first exception of a worker, which is rethrown by this thread.
+    std::exception_ptr worker_exception{};
+
+    auto format_chunks = [&] ()
+    {
+        try
+        {
+            std::vector<bio::var_io::default_record<>> chunk_records{};
+            std::optional<ReferenceGenomeCache> reference_cache = open_reference_cache();
+            while (true)
+            {
+                size_t index{};
+                {
+                    std::unique_lock lock{mutex};
+                    chunk_written.wait(lock, [&] { return next_chunk == amount_chunks ||
+                                                          next_chunk < next_written_chunk + window; });
+                    if (next_chunk == amount_chunks)
+                        return;
+                    index = next_chunk++;
+                }
+
+                format_records(chunk(index), args, reference_cache, chunk_records);
+
+                {
+                    std::lock_guard lock{mutex};
+                    std::swap(buffer[index % window], chunk_records);
+                    formatted[index % window] = true;
+                }
+                chunk_formatted.notify_all();
+            }
+        }
+        catch (...)
+        {
+            // The chunk of this worker is never formatted, thus the writer and the other workers are woken up to stop.
+            {
+                std::lock_guard lock{mutex};
+                if (worker_exception == nullptr)
+                    worker_exception = std::current_exception();
+                next_chunk = amount_chunks;
+            }
+            chunk_formatted.notify_all();
+            chunk_written.notify_all();
+        }
+    };
+
+    std::vector<std::future<void>> workers{};
+    for (size_t t = 0; t < amount_threads; ++t)
+        workers.push_back(std::async(std::launch::async, format_chunks));
+
+    try
+    {
+        for (size_t index = 0; index < amount_chunks; ++index)
         {
-            write_record(clusters[i], args, found_SV, record);
-            if (found_SV)
             {
-                writer.push_back(record);
-                ++amount_SVs;
+                std::unique_lock lock{mutex};
+                chunk_formatted.wait(lock, [&] { return formatted[index % window] ||
+                                                        worker_exception != nullptr; });
+                if (worker_exception != nullptr)
+                    std::rethrow_exception(worker_exception);
+                std::swap(records, buffer[index % window]);
+                formatted[index % window] = false;
+                ++next_written_chunk;
             }
+            chunk_written.notify_all();
+
+            for (bio::var_io::default_record<> const & record : records)
+                writer.get_writer().push_back(record);
+            amount_SVs += records.size();
         }
-        found_SV = false;
     }
+    catch (...)
+    {
+        // Stop the workers, which would otherwise wait for free space in the reorder buffer.
+        {
+            std::lock_guard lock{mutex};
+            next_chunk = amount_chunks;
+        }
+        chunk_written.notify_all();
+        throw;
+    }
+
+    for (std::future<void> & worker : workers)
+        worker.get();
+    return amount_SVs;
+}
+
+void find_and_output_variants(std::map<std::string, int32_t> & references_lengths,
+                              std::vector<Cluster> const & clusters,
+                              cmd_arguments const & args,
+                              std::filesystem::path const & output_file_path)
+{
+    VariantWriter writer{references_lengths, args, output_file_path};
+    size_t const amount_SVs = output_variants(clusters, args, writer);
+    writer.close();
 
     seqan3::debug_stream << "Detected " << amount_SVs << " SVs.\n";
 }
@@ -10,8 +10,6 @@
 #include "iGenVar.hpp"              // for global variable gVerbose
 #include "structures/junction.hpp"  // for class Junction
 
-#include "bamit/all.hpp" // for bamit index
-
 /* From a discussion we decided to add a scope guard:
  * https://github.com/seqan/iGenVar/pull/169#pullrequestreview-774811822
  * There might be subtle problem with gVerbose = true. By default it is initialized to false. Depending on the unit test
@@ -45,22 +43,3 @@ void print_compare_junction_vectors(std::vector<Junction> const & junctions_expe
                              << junctions_expected_res[i].get_tandem_dup_count() << " == " << junctions_res[i].get_tandem_dup_count() << "\n";
     }
 }
-
-// Helper function for comparing two bamit trees.
-bool compare_bamit_trees(std::unique_ptr<bamit::IntervalNode> const & t1, std::unique_ptr<bamit::IntervalNode> const & t2)
-{
-    // If both nodes are empty, return true. Else if only one node is empty, return false.
-    if (!t1 && !t2) return true;
-    if (!t1 || !t2) return false;
-
-    // If both nodes have the same contents (same start/end position and same file position), go into children.
-    // Else, return false.
-    if (std::make_tuple(t1->get_start(), t1->get_end(), t1->get_file_position()) ==
-        std::make_tuple(t2->get_start(), t2->get_end(), t2->get_file_position()))
-    {
-        return (compare_bamit_trees(t1->get_left_node(), t2->get_left_node()) &&
-                compare_bamit_trees(t1->get_right_node(), t2->get_right_node()));
-    }
-
-    return false;
-}
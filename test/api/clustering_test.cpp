@@ -1,7 +1,13 @@
 #include "api_test.hpp"
 
+#include <algorithm>  // for std::is_sorted, std::sort and std::ranges::equal, find, find_if and max_element
+#include <cmath>      // for std::abs
+#include <random>     // for std::mt19937
+
+#include "modules/clustering/candidate_selection_based_on_voting_method.hpp" // for the voting clustering method
 #include "modules/clustering/simple_clustering_method.hpp"          // for the simple clustering method
 #include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
+#include "modules/clustering/self_balancing_binary_tree_method.hpp" // for the self-balancing binary tree method
 #include "structures/cluster.hpp"                                   // for class Cluster
 
 using seqan3::operator""_dna5;
@@ -52,6 +58,28 @@ std::vector<Junction> prepare_input_junctions()
     return input_junctions;
 }
 
+// Checks that a clustering method finds the same clusters in prepare_input_junctions() as the hierarchical clustering.
+template <typename clustering_method_t>
+void expect_same_as_hierarchical_clustering(clustering_method_t && clustering_method,
+                                            std::initializer_list<double> const clustering_cutoffs)
+{
+    std::vector<Junction> const input_junctions = prepare_input_junctions();
+    for (double const clustering_cutoff : clustering_cutoffs)
+    {
+        std::vector<Cluster> const expected_clusters = hierarchical_clustering_method(input_junctions,
+                                                                                      default_partition_max_distance,
+                                                                                      clustering_cutoff);
+        std::vector<Cluster> const resulting_clusters = clustering_method(input_junctions, clustering_cutoff);
+        ASSERT_EQ(expected_clusters.size(), resulting_clusters.size()) << "cutoff: " << clustering_cutoff;
+        for (size_t cluster_index = 0; cluster_index < expected_clusters.size(); ++cluster_index)
+        {
+            EXPECT_TRUE(expected_clusters[cluster_index] == resulting_clusters[cluster_index]) << "Cluster "
+                                                                                               << cluster_index
+                                                                                               << " unequal";
+        }
+    }
+}
+
 TEST(simple_clustering, all_separate)
 {
     std::vector<Junction> input_junctions = prepare_input_junctions();
@@ -159,7 +187,7 @@ TEST(simple_clustering, empty_junction_vector)
 TEST(hierarchical_clustering, partitioning)
 {
     std::vector<Junction> input_junctions = prepare_input_junctions();
-    std::vector<std::vector<Junction>> partitions = partition_junctions(input_junctions, default_partition_max_distance);
+    std::vector<std::span<Junction>> partitions = partition_junctions(input_junctions, default_partition_max_distance);
 
     std::vector<std::vector<Junction>> expected_partitions
     {
@@ -201,6 +229,42 @@ TEST(hierarchical_clustering, partitioning)
     }
 }
 
+TEST(hierarchical_clustering, split_partition_by_sv_class)
+{
+    Junction const deletion1{Breakend{chrom1, chrom1_position1, strand::forward},
+                             Breakend{chrom1, chrom1_position1 + 1000, strand::forward},
+                             ""_dna5, tandem_dup_count, read_name_1};
+    Junction const deletion2{Breakend{chrom1, chrom1_position1 + 5, strand::forward},
+                             Breakend{chrom1, chrom1_position1 + 998, strand::forward},
+                             ""_dna5, tandem_dup_count, read_name_2};
+    Junction const insertion{Breakend{chrom1, chrom1_position1 + 3, strand::forward},
+                             Breakend{chrom1, chrom1_position1 + 4, strand::forward},
+                             "ACGTACGTAC"_dna5, tandem_dup_count, read_name_3};
+    Junction const size_zero{Breakend{chrom1, chrom1_position1 + 4, strand::forward},
+                             Breakend{chrom1, chrom1_position1 + 8, strand::forward},
+                             "ACGT"_dna5, tandem_dup_count, read_name_4};
+    Junction const inter_chromosomal{Breakend{chrom1, chrom1_position1 + 7, strand::forward},
+                                     Breakend{chrom2, chrom2_position1, strand::forward},
+                                     ""_dna5, tandem_dup_count, read_name_5};
+
+    std::vector<Junction> partition{deletion1, insertion, size_zero, deletion2, inter_chromosomal};
+    std::vector<std::span<Junction>> splitted_partition = split_partition_by_sv_class(partition);
+
+    std::vector<std::vector<Junction>> expected_splitted_partition
+    {
+        {size_zero},
+        {deletion1, deletion2},
+        {insertion},
+        {inter_chromosomal}
+    };
+    ASSERT_EQ(expected_splitted_partition.size(), splitted_partition.size());
+    for (size_t partition_index = 0; partition_index < expected_splitted_partition.size(); ++partition_index)
+    {
+        EXPECT_TRUE(std::ranges::equal(expected_splitted_partition[partition_index],
+                                       splitted_partition[partition_index]));
+    }
+}
+
 TEST(hierarchical_clustering, strict_clustering)
 {
     std::vector<Junction> input_junctions = prepare_input_junctions();
@@ -472,7 +536,7 @@ TEST(hierarchical_clustering, clustering_25)
     }
 }
 
-TEST(hierarchical_clustering, subsampling)
+TEST(hierarchical_clustering, large_partition)
 {
     auto verboseGuard = verbose_guard(true); // will reset back to the original state, after leaving this scope
 
@@ -490,16 +554,18 @@ TEST(hierarchical_clustering, subsampling)
     testing::internal::CaptureStderr();
     std::vector<Cluster> clusters = hierarchical_clustering_method(input_junctions, default_partition_max_distance, 0);
 
+    // All junctions are kept, with a cutoff of 0 each of them forms its own cluster.
+    EXPECT_EQ(clusters.size(), 300u);
     size_t num_junctions = 0;
     for (Cluster const & cluster : clusters)
     {
         num_junctions += cluster.get_cluster_size();
     }
-    EXPECT_EQ(num_junctions, 200u);
+    EXPECT_EQ(num_junctions, 300u);
 
     std::string const expected_err
     {
-        "A partition exceeds the maximum size (300>200) and has to be subsampled. "
+        "A partition exceeds the maximum size for the distance matrix (300>200) and is decomposed. "
         "Representative partition member:\n"
         "[chr1\t12323443\tForward] -> [chr2\t234432\tForward]\n"
     };
@@ -507,6 +573,237 @@ TEST(hierarchical_clustering, subsampling)
     EXPECT_EQ(expected_err, result_err);
 }
 
+TEST(hierarchical_clustering, large_partition_clusters)
+{
+    // One partition of 300 junctions, whose inserted sequences form three groups of different lengths.
+    std::vector<Junction> input_junctions;
+    for (size_t group = 0; group < 3; ++group)
+    {
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            input_junctions.emplace_back(Breakend{chrom1, chrom1_position1 + (i % 10), strand::forward},
+                                         Breakend{chrom2, chrom2_position1 + (i % 9), strand::forward},
+                                         seqan3::dna5_vector(group * 1000, 'A'_dna5),
+                                         tandem_dup_count,
+                                         read_name_1);
+        }
+    }
+    std::sort(input_junctions.begin(), input_junctions.end());
+
+    std::vector<Cluster> clusters = hierarchical_clustering_method(input_junctions,
+                                                                   default_partition_max_distance,
+                                                                   0.5);
+    ASSERT_EQ(clusters.size(), 3u);
+    for (Cluster const & cluster : clusters)
+    {
+        EXPECT_EQ(cluster.get_cluster_size(), 100u);
+    }
+
+    // A dense pile of 300 nearly identical junctions forms a single cluster.
+    input_junctions.clear();
+    for (int32_t i = 0; i < 300; ++i)
+    {
+        input_junctions.emplace_back(Breakend{chrom1, chrom1_position1 + (i % 10), strand::forward},
+                                     Breakend{chrom1, chrom1_position2 + (i % 10), strand::forward},
+                                     ""_dna5,
+                                     tandem_dup_count,
+                                     read_name_1);
+    }
+    std::sort(input_junctions.begin(), input_junctions.end());
+
+    clusters = hierarchical_clustering_method(input_junctions, default_partition_max_distance, 0.5);
+    ASSERT_EQ(clusters.size(), 1u);
+    EXPECT_EQ(clusters[0].get_cluster_size(), 300u);
+}
+
+// The clusters of the average linkage over the full distance matrix of the junctions.
+std::vector<Cluster> exact_average_linkage(std::vector<Junction> const & input_junctions,
+                                           double const clustering_cutoff)
+{
+    std::vector<double> distances{};
+    for (size_t i = 0; i < input_junctions.size(); ++i)
+        for (size_t j = i + 1; j < input_junctions.size(); ++j)
+            distances.push_back(junction_distance(input_junctions[i], input_junctions[j]));
+    std::vector<size_t> const labels = bounded_average_linkage(input_junctions.size(), distances, clustering_cutoff);
+    std::vector<std::vector<Junction>> members(*std::ranges::max_element(labels) + 1);
+    for (size_t i = 0; i < input_junctions.size(); ++i)
+        members[labels[i]].push_back(input_junctions[i]);
+    std::vector<Cluster> clusters(members.begin(), members.end());
+    std::sort(clusters.begin(), clusters.end());
+    return clusters;
+}
+
+TEST(hierarchical_clustering, large_partition_sparse_average_linkage)
+{
+    // Three piles of 100 deletions of about 1000 bp, each spread over 40 bp, whose distances are about 0.35 (first and
+    // second pile), 0.45 (second and third pile) and 0.8 (first and third pile). They form a single component, which
+    // is not compact and is clustered by the sparse average linkage, if it is requested.
+    std::vector<Junction> input_junctions;
+    for (int32_t const pile_offset : {0, 350, 800})
+    {
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            int32_t const position = chrom1_position1 + pile_offset + (i % 40);
+            input_junctions.emplace_back(Breakend{chrom1, position, strand::forward},
+                                         Breakend{chrom1, position + 1000 + (i % 7), strand::forward},
+                                         ""_dna5,
+                                         tandem_dup_count,
+                                         read_name_1);
+        }
+    }
+    std::sort(input_junctions.begin(), input_junctions.end());
+
+    // The first two piles are merged, the third one is not.
+    std::vector<Cluster> const expected_clusters = exact_average_linkage(input_junctions, 0.5);
+    ASSERT_EQ(expected_clusters.size(), 2u);
+    for (bool const approximate_large_components : {false, true})
+    {
+        std::vector<Cluster> const clusters = hierarchical_clustering_method(input_junctions,
+                                                                             default_partition_max_distance,
+                                                                             0.5,
+                                                                             1,
+                                                                             approximate_large_components);
+        ASSERT_EQ(clusters.size(), expected_clusters.size());
+        for (size_t i = 0; i < clusters.size(); ++i)
+        {
+            EXPECT_EQ(clusters[i].get_cluster_size(), expected_clusters[i].get_cluster_size());
+            EXPECT_TRUE(clusters[i] == expected_clusters[i]);
+        }
+    }
+}
+
+TEST(hierarchical_clustering, large_partition_jittered_pile)
+{
+    // A pile of 300 reads of a deletion of 1000 bp, whose breakpoints are jittered by up to 40 bp and whose sizes are
+    // jittered by up to 100 bp, like in noisy long reads.
+    std::mt19937 generator{42u};
+    auto jitter = [&generator] (uint32_t const width)
+    {
+        return static_cast<int32_t>(generator() % (width + 1)) - static_cast<int32_t>(generator() % (width + 1));
+    };
+    std::vector<Junction> input_junctions;
+    for (size_t i = 0; i < 300; ++i)
+    {
+        int32_t const position = chrom1_position1 + jitter(40);
+        input_junctions.emplace_back(Breakend{chrom1, position, strand::forward},
+                                     Breakend{chrom1, position + 1000 + jitter(100), strand::forward},
+                                     ""_dna5,
+                                     tandem_dup_count,
+                                     read_name_1);
+    }
+    std::sort(input_junctions.begin(), input_junctions.end());
+
+    // By default, the clusters are the same as the ones of the average linkage over the full distance matrix.
+    double const clustering_cutoff = 0.1;
+    std::vector<Cluster> const expected_clusters = exact_average_linkage(input_junctions, clustering_cutoff);
+    std::vector<Cluster> clusters = hierarchical_clustering_method(input_junctions,
+                                                                   default_partition_max_distance,
+                                                                   clustering_cutoff);
+    ASSERT_EQ(clusters.size(), expected_clusters.size());
+    for (size_t i = 0; i < clusters.size(); ++i)
+        EXPECT_TRUE(clusters[i] == expected_clusters[i]) << "Cluster " << i << " unequal";
+
+    // The sparse average linkage approximates them: the same number of clusters is found and less than 10 % of the
+    // pairs of junctions are in the same cluster in only one of both clusterings.
+    clusters = hierarchical_clustering_method(input_junctions,
+                                              default_partition_max_distance,
+                                              clustering_cutoff,
+                                              1,
+                                              true);
+    ASSERT_EQ(clusters.size(), expected_clusters.size());
+    auto cluster_labels = [&input_junctions] (std::vector<Cluster> const & clustering)
+    {
+        std::vector<size_t> labels(input_junctions.size());
+        for (size_t i = 0; i < input_junctions.size(); ++i)
+        {
+            labels[i] = std::ranges::find_if(clustering, [&] (Cluster const & cluster)
+            {
+                return std::ranges::find(cluster.get_members(), input_junctions[i]) != cluster.get_members().end();
+            }) - clustering.begin();
+        }
+        return labels;
+    };
+    std::vector<size_t> const expected_labels = cluster_labels(expected_clusters);
+    std::vector<size_t> const labels = cluster_labels(clusters);
+    size_t disagreeing_pairs = 0;
+    for (size_t i = 0; i < input_junctions.size(); ++i)
+        for (size_t j = i + 1; j < input_junctions.size(); ++j)
+            disagreeing_pairs += (expected_labels[i] == expected_labels[j]) != (labels[i] == labels[j]);
+    EXPECT_LT(disagreeing_pairs, input_junctions.size() * (input_junctions.size() - 1) / 2 / 10);
+}
+
+TEST(hierarchical_clustering, bounded_average_linkage)
+{
+    // Elements at the positions 0, 1, 2, 10, 11 and 30 with their absolute differences as distances.
+    std::vector<double> const positions{0, 1, 2, 10, 11, 30};
+    std::vector<double> distances{};
+    for (size_t i = 0; i < positions.size(); ++i)
+        for (size_t j = i + 1; j < positions.size(); ++j)
+            distances.push_back(std::abs(positions[i] - positions[j]));
+
+    std::vector<double> distances_copy{distances};
+    EXPECT_EQ((std::vector<size_t>{0, 0, 0, 1, 1, 2}), bounded_average_linkage(positions.size(), distances_copy, 3));
+    distances_copy = distances;
+    // Only clusters with an average distance smaller than the cutoff are merged.
+    EXPECT_EQ((std::vector<size_t>{0, 1, 2, 3, 4, 5}), bounded_average_linkage(positions.size(), distances_copy, 1));
+    distances_copy = distances;
+    EXPECT_EQ((std::vector<size_t>{0, 0, 0, 0, 0, 1}), bounded_average_linkage(positions.size(), distances_copy, 10));
+
+    // Ties are resolved in favour of the previous cluster of the chain and otherwise of the smallest first element:
+    // the chain starts at 0, whose nearest neighbour is 1, and 1 is as near to 0 as to 2, thus it joins 0 and {0, 1}
+    // and {2, 3} are clustered from 0, 1, 2 and 3.
+    std::vector<double> ties{1, 2, 1};  // positions 0, 1 and 2
+    EXPECT_EQ((std::vector<size_t>{0, 0, 1}), bounded_average_linkage(3, ties, 1.5));
+    ties = {1, 2, 3, 1, 2, 1};          // positions 0, 1, 2 and 3
+    EXPECT_EQ((std::vector<size_t>{0, 0, 1, 1}), bounded_average_linkage(4, ties, 1.2));
+    // A merged cluster is represented by its first element: of the elements at the positions 5, 3, 4, 2 and 5, 0 and 4
+    // are merged first and the next chain starts at {0, 4} instead of 1. 2 is as near to {0, 4} as to 1 and joins
+    // {0, 4}, then 1 and 3 are merged and their average distance to {0, 2, 4} is above the cutoff.
+    ties = {2, 1, 3, 0, 1, 1, 2, 2, 1, 3};  // positions 5, 3, 4, 2 and 5
+    EXPECT_EQ((std::vector<size_t>{0, 1, 0, 1, 0}), bounded_average_linkage(5, ties, 2));
+}
+
+TEST(hierarchical_clustering, multiple_threads)
+{
+    std::vector<Junction> input_junctions;
+    // Partitions of different sizes on both chromosomes, the last partition exceeds the size of
+    // the distance matrix.
+    for (int32_t partition = 0; partition < 8; ++partition)
+    {
+        for (int32_t i = 0; i < 10 + partition * 30; ++i)
+        {
+            std::string const & chrom = (partition % 2 == 0) ? chrom1 : chrom2;
+            int32_t const offset = partition * 10000;
+            input_junctions.emplace_back(Breakend{chrom, chrom1_position1 + offset + (i % 7), strand::forward},
+                                         Breakend{chrom, chrom1_position2 + offset + i * 10, strand::forward},
+                                         ""_dna5,
+                                         tandem_dup_count,
+                                         read_name_1);
+        }
+    }
+    std::sort(input_junctions.begin(), input_junctions.end());
+
+    std::vector<Cluster> expected_clusters = hierarchical_clustering_method(input_junctions,
+                                                                            default_partition_max_distance,
+                                                                            0.5);
+    for (size_t threads : {2u, 4u, 16u})
+    {
+        std::vector<Cluster> resulting_clusters = hierarchical_clustering_method(input_junctions,
+                                                                                 default_partition_max_distance,
+                                                                                 0.5,
+                                                                                 threads);
+        ASSERT_EQ(expected_clusters.size(), resulting_clusters.size()) << "threads: " << threads;
+        for (size_t cluster_index = 0; cluster_index < expected_clusters.size(); ++cluster_index)
+        {
+            EXPECT_TRUE(expected_clusters[cluster_index] == resulting_clusters[cluster_index]) << "Cluster "
+                                                                                               << cluster_index
+                                                                                               << " unequal with "
+                                                                                               << threads
+                                                                                               << " threads";
+        }
+    }
+}
+
 TEST(hierarchical_clustering, cluster_tandem_dup_count)
 {
     std::vector<Junction> input_junctions
@@ -571,3 +868,81 @@ TEST(hierarchical_clustering, cluster_tandem_dup_count)
     resulting_clusters = hierarchical_clustering_method(input_junctions, default_partition_max_distance, 10);  // clustering_cutoff = 10 (default value)
     ASSERT_EQ(1u, resulting_clusters.size());
 }
+
+TEST(self_balancing_binary_tree_clustering, same_as_hierarchical_clustering)
+{
+    // The partitions of the input junctions are compact and far apart, thus both methods find the same clusters.
+    expect_same_as_hierarchical_clustering([] (std::vector<Junction> const & junctions, double const cutoff)
+    {
+        return self_balancing_binary_tree_method(junctions, default_partition_max_distance, cutoff);
+    }, {0.0, 0.5, 10.0});
+}
+
+TEST(self_balancing_binary_tree_clustering, online_insertion)
+{
+    // Insertions of about 500 bp and deletions of about 2000 bp at the same positions.
+    std::vector<Junction> input_junctions;
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        input_junctions.emplace_back(Breakend{chrom1, chrom1_position1 + i, strand::forward},
+                                     Breakend{chrom1, chrom1_position1 + i + 1, strand::forward},
+                                     seqan3::dna5_vector(500 + i, 'A'_dna5),
+                                     tandem_dup_count,
+                                     read_name_1);
+        input_junctions.emplace_back(Breakend{chrom1, chrom1_position1 + i, strand::forward},
+                                     Breakend{chrom1, chrom1_position1 + 2000 - i, strand::forward},
+                                     ""_dna5,
+                                     tandem_dup_count,
+                                     read_name_2);
+    }
+
+    SelfBalancingBinaryTreeClusterer clusterer{default_partition_max_distance, 0.3};
+    for (auto it = input_junctions.rbegin(); it != input_junctions.rend(); ++it)
+    {
+        clusterer.insert(std::move(*it));
+    }
+    EXPECT_EQ(clusterer.size(), 2u);
+
+    std::vector<Cluster> clusters = clusterer.extract_clusters();
+    EXPECT_EQ(clusterer.size(), 0u);
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[0].get_cluster_size(), 20u);
+    EXPECT_EQ(clusters[1].get_cluster_size(), 20u);
+    EXPECT_TRUE(std::is_sorted(clusters[0].get_members().begin(), clusters[0].get_members().end()));
+    EXPECT_TRUE(std::is_sorted(clusters[1].get_members().begin(), clusters[1].get_members().end()));
+    EXPECT_NE(clusters[0].get_average_mate2(), clusters[1].get_average_mate2());
+}
+
+TEST(candidate_selection_based_on_voting, same_as_hierarchical_clustering)
+{
+    expect_same_as_hierarchical_clustering([] (std::vector<Junction> const & junctions, double const cutoff)
+    {
+        return candidate_selection_based_on_voting_method(junctions, cutoff);
+    }, {0.0, 0.5});
+}
+
+TEST(candidate_selection_based_on_voting, deep_coverage)
+{
+    // 500 reads each support a deletion of about 2000 bp and an insertion of about 500 bp at the same position.
+    std::vector<Junction> input_junctions;
+    for (int32_t i = 0; i < 500; ++i)
+    {
+        input_junctions.emplace_back(Breakend{chrom1, chrom1_position1 + (i % 40), strand::forward},
+                                     Breakend{chrom1, chrom1_position1 + 2000 - (i % 20), strand::forward},
+                                     ""_dna5,
+                                     tandem_dup_count,
+                                     read_name_1);
+        input_junctions.emplace_back(Breakend{chrom1, chrom1_position1 + (i % 40), strand::forward},
+                                     Breakend{chrom1, chrom1_position1 + (i % 40) + 1, strand::forward},
+                                     seqan3::dna5_vector(500 + (i % 10), 'A'_dna5),
+                                     tandem_dup_count,
+                                     read_name_2);
+    }
+    std::sort(input_junctions.begin(), input_junctions.end());
+
+    std::vector<Cluster> clusters = candidate_selection_based_on_voting_method(input_junctions, 0.3);
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[0].get_cluster_size(), 500u);
+    EXPECT_EQ(clusters[1].get_cluster_size(), 500u);
+    EXPECT_TRUE(std::is_sorted(clusters[0].get_members().begin(), clusters[0].get_members().end()));
+}
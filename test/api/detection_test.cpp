@@ -230,6 +230,22 @@ TEST(junction_detection, retrieve_aligned_segments)
     }
 }
 
+TEST(junction_detection, retrieve_aligned_segments_wrong_format)
+{
+    // Segments with a wrong amount of parameters, an invalid strand, position, mapping quality or CIGAR string are
+    // skipped, the valid segments in between are kept. A missing "chr" prefix is added.
+    std::string const sa_tag = "chr1,101,+,6M94S,60;1,101,*,6M94S,60,0;chr1,1x1,+,6M94S,60,0;chr1,101,+,6M94S,,0;"
+                               "chr1,101,+,6Y94S,60,0;chr1,101,+,94S6,60,0;2,101,-,6S10M84S,60,0;;";
+    std::vector<AlignedSegment> segments_res{};
+    retrieve_aligned_segments(sa_tag, segments_res);
+
+    AlignedSegment aligned_segment {strand::reverse, "chr2", 100, 60, std::vector<seqan3::cigar>{{6, 'S'_cigar_operation},
+                                                                                                 {10, 'M'_cigar_operation},
+                                                                                                 {84, 'S'_cigar_operation}}};
+    ASSERT_EQ(segments_res.size(), 1u);
+    EXPECT_TRUE(aligned_segment == segments_res[0]);
+}
+
 TEST(junction_detection, analyze_aligned_segments)
 {
     auto verboseGuard = verbose_guard(true); // will reset back to the original state, after leaving this scope
@@ -1,18 +1,26 @@
 #include "api_test.hpp"
 
+#include <algorithm>  // for std::is_sorted, std::ranges::equal and std::sort
+#include <array>
 #include <fstream>
+#include <sstream>
+
+#include <zlib.h>     // for gzopen and gzread
+
+#include <bio/var_io/reader.hpp>
 
 #include <seqan3/io/exception.hpp>
 
+#include "variant_detection/bgzf_output.hpp"        // for class VcfIndexBuilder
 #include "variant_detection/variant_detection.hpp"  // for detect_junctions_in_long_reads_sam_file()
 #include "variant_detection/variant_output.hpp"       // for find_and_output_variants()
 
 using seqan3::operator""_dna5;
 
 std::string const default_alignment_short_reads_file_path = DATADIR"paired_end_mini_example.sam";
-std::filesystem::path const short_reads_bamit_path = DATADIR"paired_end_mini_example.sam.bit";
+std::filesystem::path const short_reads_index_path = DATADIR"paired_end_mini_example.sam.igvi";
 std::string const default_alignment_long_reads_file_path = DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam";
-std::filesystem::path const long_reads_bamit_path = DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam.bit";
+std::filesystem::path const long_reads_index_path = DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam.igvi";
 std::filesystem::path const empty_path{};
 std::string default_vcf_sample_name{"MYSAMPLE"};
 constexpr int16_t default_threads = 1;
@@ -82,7 +90,7 @@ TEST(input_file, detect_junctions_in_short_read_sam_file)
         // print_compare_junction_vectors(junctions_expected_res, junctions_res);
     }
 
-    std::filesystem::remove(short_reads_bamit_path);
+    std::filesystem::remove(short_reads_index_path);
 }
 
 TEST(input_file, detect_junctions_in_long_reads_sam_file)
@@ -191,6 +199,67 @@ TEST(input_file, detect_junctions_in_long_reads_sam_file)
     }
 }
 
+TEST(input_file, detect_junctions_in_long_reads_sam_file_parallel)
+{
+    cmd_arguments args{"",
+                       default_alignment_long_reads_file_path,
+                       empty_path, // empty genome path,
+                       empty_path, // empty output path,
+                       default_vcf_sample_name,
+                       empty_path, // empty junctions path,
+                       empty_path, // empty clusters path,
+                       default_threads,
+                       default_methods,
+                       simple_clustering,
+                       no_refinement,
+                       default_min_length,
+                       default_max_var_length,
+                       default_max_tol_inserted_length,
+                       default_max_tol_deleted_length,
+                       default_max_overlap,
+                       default_min_qual,
+                       default_partition_max_distance,
+                       default_hierarchical_clustering_cutoff};
+
+    std::vector<Junction> junctions_expected_res{};
+    std::map<std::string, int32_t> references_lengths{};
+    testing::internal::CaptureStderr(); // ignore the messages of the read depth method
+    detect_junctions_in_long_reads_sam_file(junctions_expected_res, references_lengths, args);
+
+    // The parallel analysis finds the same junctions in the same order as the sequential analysis.
+    args.threads = 4;
+    std::vector<Junction> junctions_res{};
+    detect_junctions_in_long_reads_sam_file(junctions_res, references_lengths, args);
+    testing::internal::GetCapturedStderr();
+
+    ASSERT_EQ(junctions_expected_res.size(), junctions_res.size());
+    for (size_t i = 0; i < junctions_expected_res.size(); ++i)
+    {
+        EXPECT_EQ(junctions_expected_res[i].get_read_name(), junctions_res[i].get_read_name());
+        EXPECT_TRUE(junctions_expected_res[i] == junctions_res[i]);
+    }
+
+    // The streaming mode hands over the same junctions sorted as in batch mode, split into batches of whole partitions.
+    std::sort(junctions_expected_res.begin(), junctions_expected_res.end());
+    std::vector<Junction> junctions_streamed{};
+    size_t amount_batches = 0;
+    testing::internal::CaptureStderr();
+    stream_junctions_in_long_reads_sam_file(references_lengths, args, [] () {}, [&] (std::vector<Junction> & batch)
+    {
+        EXPECT_TRUE(std::is_sorted(batch.begin(), batch.end()));
+        junctions_streamed.insert(junctions_streamed.end(), batch.begin(), batch.end());
+        ++amount_batches;
+    });
+    testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(amount_batches, 1u);
+    ASSERT_EQ(junctions_expected_res.size(), junctions_streamed.size());
+    for (size_t i = 0; i < junctions_expected_res.size(); ++i)
+    {
+        EXPECT_TRUE(junctions_expected_res[i] == junctions_streamed[i]);
+    }
+}
+
 TEST(input_file, long_read_sam_file_unsorted)
 {
     std::vector<Junction> junctions_res{};
@@ -244,8 +313,6 @@ TEST(input_file, short_and_long_read_sam_file_with_different_references_lengths)
         "Warning: The reference id chr2 was found twice in the input files with different length: 1001 and 1005\n"
         "Warning: The reference id chr4 was found twice in the input files with different length: 1004 and 1005\n"
         "The read depth method for long reads is not yet implemented.\n"
-        "The read depth method for long reads is not yet implemented.\n"
-        "The read depth method for long reads is not yet implemented.\n"
     };
 
     std::vector<Junction> junctions_res{};
@@ -255,8 +322,8 @@ TEST(input_file, short_and_long_read_sam_file_with_different_references_lengths)
 
     // Create a blank short read SAM file with SQ header tag with different length of one reference.
     std::filesystem::path short_sam_path{tmp_dir/"short.sam"};
-    std::filesystem::path short_sam_bamit_path = short_sam_path;
-    short_sam_bamit_path += ".bit";
+    std::filesystem::path short_sam_index_path = short_sam_path;
+    short_sam_index_path += ".igvi";
     std::ofstream short_sam{short_sam_path.c_str()};
     short_sam << "@HD\tVN:1.6\tSO:coordinate\n"
               << "@SQ\tSN:chr1\tLN:1000\n"          // chr1 present in both files with same length
@@ -270,8 +337,8 @@ TEST(input_file, short_and_long_read_sam_file_with_different_references_lengths)
 
     // Create a blank long read SAM file with SQ header tag with different length of one reference.
     std::filesystem::path long_sam_path{tmp_dir/"long.sam"};
-    std::filesystem::path long_sam_bamit_path = long_sam_path;
-    long_sam_bamit_path += ".bit";
+    std::filesystem::path long_sam_index_path = long_sam_path;
+    long_sam_index_path += ".igvi";
     std::ofstream long_sam{long_sam_path.c_str()};
     long_sam << "@HD\tVN:1.6\tSO:coordinate\n"
              << "@SQ\tSN:chr1\tLN:1000\n"
@@ -303,11 +370,11 @@ TEST(input_file, short_and_long_read_sam_file_with_different_references_lengths)
                        default_partition_max_distance,
                        default_hierarchical_clustering_cutoff};
     EXPECT_NO_THROW(detect_junctions_in_short_reads_sam_file(junctions_res, references_lengths, args));
-    std::filesystem::remove(short_sam_bamit_path);
-    std::filesystem::remove(long_sam_bamit_path);
+    std::filesystem::remove(short_sam_index_path);
+    std::filesystem::remove(long_sam_index_path);
     EXPECT_NO_THROW(detect_junctions_in_long_reads_sam_file(junctions_res, references_lengths, args));
-    std::filesystem::remove(short_sam_bamit_path);
-    std::filesystem::remove(long_sam_bamit_path);
+    std::filesystem::remove(short_sam_index_path);
+    std::filesystem::remove(long_sam_index_path);
 
     std::string result_out = testing::internal::GetCapturedStdout();
     EXPECT_EQ("", result_out);
@@ -318,17 +385,59 @@ TEST(input_file, short_and_long_read_sam_file_with_different_references_lengths)
     std::filesystem::remove(long_sam_path);
 }
 
-TEST(input_file, bamit_create_and_load)
+TEST(input_file, alignment_index_create_and_load)
 {
-    std::vector<std::unique_ptr<bamit::IntervalNode>> short_read_create_index = load_or_create_index(default_alignment_short_reads_file_path);
-    std::vector<std::unique_ptr<bamit::IntervalNode>> short_read_load_index = load_or_create_index(default_alignment_short_reads_file_path);
+    std::filesystem::remove(short_reads_index_path);
+    AlignmentIndex const short_read_create_index = load_or_create_index(default_alignment_short_reads_file_path);
+    AlignmentIndex const short_read_load_index = load_or_create_index(default_alignment_short_reads_file_path);
     ASSERT_EQ(short_read_create_index.size(), short_read_load_index.size());
     for (size_t i = 0; i < short_read_create_index.size(); ++i)
     {
-        EXPECT_TRUE(compare_bamit_trees(short_read_create_index[i], short_read_load_index[i]));
+        EXPECT_TRUE(std::ranges::equal(short_read_create_index.windows(i), short_read_load_index.windows(i)));
+    }
+
+    std::filesystem::remove(short_reads_index_path);
+}
+
+TEST(input_file, alignment_index_created_during_detection)
+{
+    std::filesystem::remove(short_reads_index_path);
+
+    std::vector<Junction> junctions_res{};
+    std::map<std::string, int32_t> references_lengths{};
+    cmd_arguments args{default_alignment_short_reads_file_path,
+                       "",
+                       empty_path, // empty genome path,
+                       empty_path, // empty output path,
+                       default_vcf_sample_name,
+                       empty_path, // empty junctions path,
+                       empty_path, // empty clusters path,
+                       default_threads,
+                       default_methods,
+                       simple_clustering,
+                       sVirl_refinement_method,
+                       default_min_length,
+                       default_max_var_length,
+                       default_max_tol_inserted_length,
+                       default_max_tol_deleted_length,
+                       default_max_overlap,
+                       default_min_qual,
+                       default_partition_max_distance,
+                       default_hierarchical_clustering_cutoff};
+    detect_junctions_in_short_reads_sam_file(junctions_res, references_lengths, args);
+    ASSERT_TRUE(std::filesystem::exists(short_reads_index_path));
+
+    // The index built during the detection equals the index built in a separate pass.
+    AlignmentIndex const detection_index = load_or_create_index(default_alignment_short_reads_file_path);
+    std::filesystem::remove(short_reads_index_path);
+    AlignmentIndex const separate_index = load_or_create_index(default_alignment_short_reads_file_path);
+    ASSERT_EQ(detection_index.size(), separate_index.size());
+    for (size_t i = 0; i < detection_index.size(); ++i)
+    {
+        EXPECT_TRUE(std::ranges::equal(detection_index.windows(i), separate_index.windows(i)));
     }
 
-    std::filesystem::remove(short_reads_bamit_path);
+    std::filesystem::remove(short_reads_index_path);
 }
 
 TEST(output_file, output_file_fail)
@@ -345,3 +454,304 @@ TEST(output_file, output_file_fail)
     EXPECT_NO_THROW(find_and_output_variants(empty_map, empty_vec, empty_args, fail_path));
     std::filesystem::remove_all(fail_path);
 }
+
+TEST(output_file, parallel_output)
+{
+    // Enough clusters for several chunks of records, of which every third is filtered by its quality.
+    std::vector<Cluster> clusters{};
+    for (int32_t i = 0; i < 10000; ++i)
+    {
+        std::vector<Junction> members{};
+        for (int32_t j = 0; j <= i % 3; ++j)
+        {
+            members.emplace_back(Breakend{"chr1", 1000 + i * 100, strand::forward},
+                                 Breakend{"chr1", 1050 + i * 100 + i % 50, strand::forward},
+                                 ""_dna5, 0, "read_" + std::to_string(j));
+        }
+        clusters.emplace_back(std::move(members));
+    }
+    std::map<std::string, int32_t> references_lengths{{"chr1", 2000000}};
+    cmd_arguments args{};
+    args.min_qual = 2;
+
+    // Returns the output without the filedate header line, which depends on the time of writing.
+    auto read_output = [] (std::filesystem::path const & output_path)
+    {
+        std::ifstream output_file{output_path};
+        std::string output{};
+        for (std::string line{}; std::getline(output_file, line);)
+        {
+            if (!line.starts_with("##filedate"))
+                output += line + '\n';
+        }
+        return output;
+    };
+
+    std::filesystem::path const tmp_dir = std::filesystem::temp_directory_path();
+    args.threads = 1;
+    find_and_output_variants(references_lengths, clusters, args, tmp_dir/"sequential_output.vcf");
+    args.threads = 4;
+    find_and_output_variants(references_lengths, clusters, args, tmp_dir/"parallel_output.vcf");
+
+    std::string const sequential_output = read_output(tmp_dir/"sequential_output.vcf");
+    EXPECT_NE(sequential_output.find("<DEL>"), std::string::npos);
+    EXPECT_EQ(sequential_output, read_output(tmp_dir/"parallel_output.vcf"));
+    std::filesystem::remove(tmp_dir/"sequential_output.vcf");
+    std::filesystem::remove(tmp_dir/"parallel_output.vcf");
+}
+
+TEST(output_file, compressed_output)
+{
+    std::vector<Cluster> clusters{};
+    for (int32_t i = 0; i < 10000; ++i)
+    {
+        std::vector<Junction> members{};
+        for (int32_t j = 0; j < 2; ++j)
+        {
+            members.emplace_back(Breakend{(i < 5000) ? "chr1" : "chr2", 1000 + (i % 5000) * 100, strand::forward},
+                                 Breakend{(i < 5000) ? "chr1" : "chr2", 1050 + (i % 5000) * 100 + i % 50,
+                                          strand::forward},
+                                 ""_dna5, 0, "read_" + std::to_string(j));
+        }
+        clusters.emplace_back(std::move(members));
+    }
+    std::map<std::string, int32_t> references_lengths{{"chr1", 1000000}, {"chr2", 1000000}};
+    cmd_arguments args{};
+    args.min_qual = 2;
+
+    // Returns the text without the filedate header line, which depends on the time of writing.
+    auto without_filedate = [] (std::istream & text)
+    {
+        std::string output{};
+        for (std::string line{}; std::getline(text, line);)
+        {
+            if (!line.starts_with("##filedate"))
+                output += line + '\n';
+        }
+        return output;
+    };
+    auto decompress = [] (std::filesystem::path const & output_path)
+    {
+        gzFile output_file = gzopen(output_path.c_str(), "rb");
+        std::string text{};
+        std::array<char, 4096> buffer{};
+        for (int size = gzread(output_file, buffer.data(), buffer.size()); size > 0;
+             size = gzread(output_file, buffer.data(), buffer.size()))
+        {
+            text.append(buffer.data(), size);
+        }
+        gzclose(output_file);
+        return std::istringstream{text};
+    };
+
+    std::filesystem::path const tmp_dir = std::filesystem::temp_directory_path();
+    find_and_output_variants(references_lengths, clusters, args, tmp_dir/"plain_output.vcf");
+    std::ifstream plain_file{tmp_dir/"plain_output.vcf"};
+    std::string const plain_output = without_filedate(plain_file);
+    EXPECT_NE(plain_output.find("chr2\t"), std::string::npos);
+
+    for (uint64_t const threads : {1, 4})
+    {
+        args.threads = threads;
+        find_and_output_variants(references_lengths, clusters, args, tmp_dir/"compressed_output.vcf.gz");
+        std::istringstream compressed_text = decompress(tmp_dir/"compressed_output.vcf.gz");
+        std::string const text = compressed_text.str();
+        EXPECT_EQ(plain_output, without_filedate(compressed_text));
+        ASSERT_TRUE(std::filesystem::exists(tmp_dir/"compressed_output.vcf.gz.tbi"));
+
+        // Look up the region chr2:300001 like tabix: the chunks of the bins, which overlap the region, are read from
+        // the smallest offset of its 16 kbp window in the linear index on.
+        int64_t const region_begin = 300000;
+        std::vector<uint32_t> const region_bins{0,
+                                                1 + (region_begin >> 26),
+                                                9 + (region_begin >> 23),
+                                                73 + (region_begin >> 20),
+                                                585 + (region_begin >> 17),
+                                                4681 + (region_begin >> 14)};
+        auto little_endian = [] (std::string const & data, size_t const begin, size_t const bytes)
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < bytes; ++i)
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(data[begin + i])) << (8 * i);
+            return value;
+        };
+        std::string const index = decompress(tmp_dir/"compressed_output.vcf.gz.tbi").str();
+        size_t position = 0;
+        auto read_little_endian = [&] (size_t const bytes)
+        {
+            position += bytes;
+            return little_endian(index, position - bytes, bytes);
+        };
+        ASSERT_EQ(index.substr(0, 4), "TBI\1");
+        position = 4;
+        ASSERT_EQ(read_little_endian(4), 2u);
+        position += 6 * 4;
+        position += read_little_endian(4); // the names of the reference sequences
+        std::vector<std::pair<uint64_t, uint64_t>> chunks{};
+        uint64_t window_offset = 0;
+        for (size_t reference = 0; reference < 2; ++reference)
+        {
+            for (uint64_t amount_bins = read_little_endian(4); amount_bins > 0; --amount_bins)
+            {
+                uint32_t const bin = read_little_endian(4);
+                for (uint64_t amount_chunks = read_little_endian(4); amount_chunks > 0; --amount_chunks)
+                {
+                    uint64_t const begin = read_little_endian(8);
+                    uint64_t const end = read_little_endian(8);
+                    if (reference == 1 && std::ranges::find(region_bins, bin) != region_bins.end())
+                        chunks.emplace_back(begin, end);
+                }
+            }
+            uint64_t const amount_windows = read_little_endian(4);
+            for (uint64_t window = 0; window < amount_windows; ++window)
+            {
+                uint64_t const offset = read_little_endian(8);
+                if (reference == 1 && window == (region_begin >> 14))
+                    window_offset = offset;
+            }
+        }
+        EXPECT_EQ(position, index.size());
+
+        // A virtual file offset points to a BGZF block of the compressed file and to an offset in its uncompressed
+        // text. The size of a block is stored in its header and the size of its uncompressed text at its end.
+        std::ifstream compressed_file{tmp_dir/"compressed_output.vcf.gz", std::ios::binary};
+        std::string const compressed{std::istreambuf_iterator<char>{compressed_file}, {}};
+        std::map<uint64_t, uint64_t> text_offset_of_block{};
+        for (uint64_t block = 0, text_offset = 0; block < compressed.size();)
+        {
+            uint64_t const block_size = little_endian(compressed, block + 16, 2) + 1;
+            text_offset_of_block[block] = text_offset;
+            text_offset += little_endian(compressed, block + block_size - 4, 4);
+            block += block_size;
+        }
+        auto uncompressed_offset = [&text_offset_of_block] (uint64_t const virtual_offset)
+        {
+            return text_offset_of_block.at(virtual_offset >> 16) + (virtual_offset & 0xffff);
+        };
+
+        std::vector<std::string> found_records{};
+        for (auto const & [begin, end] : chunks)
+        {
+            if (end <= window_offset)
+                continue;
+            uint64_t const chunk_begin = uncompressed_offset(std::max(begin, window_offset));
+            std::istringstream chunk_text{text.substr(chunk_begin, uncompressed_offset(end) - chunk_begin)};
+            for (std::string line{}; std::getline(chunk_text, line);)
+                found_records.push_back(line.substr(0, line.find('\t', 5)));
+        }
+        EXPECT_NE(std::ranges::find(found_records, "chr2\t300001"), found_records.end());
+        EXPECT_TRUE(std::ranges::all_of(found_records, [] (std::string const & record)
+        {
+            return record.starts_with("chr2\t");
+        }));
+
+        std::filesystem::remove(tmp_dir/"compressed_output.vcf.gz");
+        std::filesystem::remove(tmp_dir/"compressed_output.vcf.gz.tbi");
+    }
+    std::filesystem::remove(tmp_dir/"plain_output.vcf");
+
+    // No index is written for records, which are not sorted by their reference sequence and position.
+    VcfIndexBuilder sorted_index{1000000};
+    sorted_index.add_text("chr1\t100\t.\tN\t<DEL>\t2\tPASS\tEND=200\nchr1\t150\t.\tN\t<DEL>\t2\tPASS\tEND=160\n");
+    EXPECT_TRUE(sorted_index.is_valid());
+    VcfIndexBuilder unsorted_index{sorted_index};
+    unsorted_index.add_text("chr1\t120\t.\tN\t<DEL>\t2\tPASS\tEND=300\n");
+    EXPECT_FALSE(unsorted_index.is_valid());
+    sorted_index.add_text("chr2\t10\t.\tN\t<DEL>\t2\tPASS\tEND=300\nchr1\t200\t.\tN\t<DEL>\t2\tPASS\tEND=300\n");
+    EXPECT_FALSE(sorted_index.is_valid());
+}
+
+TEST(output_file, bcf_output)
+{
+    std::vector<Cluster> clusters{};
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        std::vector<Junction> members{};
+        for (int32_t j = 0; j < 2; ++j)
+        {
+            members.emplace_back(Breakend{(i < 500) ? "chr1" : "chr2", 1000 + (i % 500) * 100, strand::forward},
+                                 Breakend{(i < 500) ? "chr1" : "chr2", 1050 + (i % 500) * 100 + i % 50,
+                                          strand::forward},
+                                 ""_dna5, 0, "read_" + std::to_string(j));
+        }
+        clusters.emplace_back(std::move(members));
+    }
+    std::map<std::string, int32_t> references_lengths{{"chr1", 1000000}, {"chr2", 1000000}};
+    cmd_arguments args{};
+    args.min_qual = 2;
+
+    // Returns the position and ALT of each record, which are equal in both formats.
+    auto read_records = [] (std::filesystem::path const & output_path)
+    {
+        std::vector<std::string> records{};
+        bio::var_io::reader reader{output_path};
+        for (auto & record : reader)
+        {
+            records.push_back(std::string{record.chrom()} + ":" + std::to_string(record.pos()) + " " +
+                              std::string{record.alt().front()});
+        }
+        return records;
+    };
+
+    std::filesystem::path const tmp_dir = std::filesystem::temp_directory_path();
+    find_and_output_variants(references_lengths, clusters, args, tmp_dir/"text_output.vcf");
+    find_and_output_variants(references_lengths, clusters, args, tmp_dir/"binary_output.bcf");
+
+    std::vector<std::string> const text_records = read_records(tmp_dir/"text_output.vcf");
+    EXPECT_EQ(text_records.size(), 1000u);
+    EXPECT_EQ(text_records, read_records(tmp_dir/"binary_output.bcf"));
+    std::filesystem::remove(tmp_dir/"text_output.vcf");
+    std::filesystem::remove(tmp_dir/"binary_output.bcf");
+}
+
+TEST(output_file, reference_alleles)
+{
+    std::string reference{};
+    {
+        std::ifstream fasta_file{DATADIR"mini_example_reference.fasta"};
+        for (std::string line{}; std::getline(fasta_file, line);)
+        {
+            if (!line.starts_with('>'))
+                reference += line;
+        }
+    }
+
+    // A deletion of the bases [101, 140), an insertion behind the base 200 and a deletion on chr2, which is missing in
+    // the reference genome.
+    std::vector<Cluster> const clusters{
+        Cluster{{Junction{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 140, strand::forward}, ""_dna5, 0,
+                          "read_1"}}},
+        Cluster{{Junction{Breakend{"chr1", 200, strand::forward}, Breakend{"chr1", 201, strand::forward},
+                          "ACGTACGTACGTACGTACGTACGTACGTACGTACGTA"_dna5, 0, "read_2"}}},
+        Cluster{{Junction{Breakend{"chr2", 100, strand::forward}, Breakend{"chr2", 140, strand::forward}, ""_dna5, 0,
+                          "read_3"}}}};
+    std::map<std::string, int32_t> references_lengths{{"chr1", 610}, {"chr2", 610}};
+    cmd_arguments args{};
+    args.genome_file_path = DATADIR"mini_example_reference.fasta";
+    args.min_qual = 1;
+
+    std::filesystem::path const output_path = std::filesystem::temp_directory_path()/"reference_output.vcf";
+    find_and_output_variants(references_lengths, clusters, args, output_path);
+
+    // Returns the REF and ALT column of each record.
+    std::vector<std::pair<std::string, std::string>> alleles{};
+    std::ifstream output_file{output_path};
+    for (std::string line{}; std::getline(output_file, line);)
+    {
+        if (line.starts_with('#'))
+            continue;
+        std::istringstream fields{line};
+        std::string chrom{}, pos{}, id{}, ref{}, alt{};
+        fields >> chrom >> pos >> id >> ref >> alt;
+        alleles.emplace_back(ref, alt);
+    }
+
+    ASSERT_EQ(alleles.size(), 3u);
+    EXPECT_EQ(alleles[0].first, reference.substr(100, 40));
+    EXPECT_EQ(alleles[0].second, reference.substr(100, 1));
+    EXPECT_EQ(alleles[1].first, reference.substr(200, 1));
+    EXPECT_EQ(alleles[1].second, "<INS>");
+    EXPECT_EQ(alleles[2].first, "N");
+    EXPECT_EQ(alleles[2].second, "<DEL>");
+    std::filesystem::remove(output_path);
+}
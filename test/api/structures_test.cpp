@@ -1,7 +1,16 @@
 #include "api_test.hpp"
 
+#include <algorithm> // for std::ranges::equal and std::sort
+#include <fstream>   // for std::fstream and std::ofstream
+
 #include "structures/aligned_segment.hpp"
+#include "structures/alignment_index.hpp"
 #include "structures/breakend.hpp"
+#include "structures/cluster.hpp"
+#include "structures/genomic_region.hpp"
+#include "structures/interned_string.hpp"
+#include "structures/junction_dump.hpp"
+#include "structures/reference_genome.hpp"
 #include "variant_detection/method_enums.hpp"
 
 /* tests for aligned_segment */
@@ -23,6 +32,14 @@ TEST(structures, aligned_segment)
         EXPECT_EQ(aligned_segment.get_left_soft_clip(), 0);
     }
 
+    // get_reference_start() and get_cigar()
+    {
+        std::vector<seqan3::cigar> const cig = {{10, 'S'_cigar_operation}, {5, 'M'_cigar_operation}};
+        AlignedSegment const aligned_segment = {strand::forward, "chr1", 100, 60, cig};
+        EXPECT_EQ(aligned_segment.get_reference_start(), 100);
+        EXPECT_EQ(aligned_segment.get_cigar(), cig);
+    }
+
     // get_query_length()
     {
         // zero query length
@@ -30,6 +47,88 @@ TEST(structures, aligned_segment)
         AlignedSegment aligned_segment = {strand::forward, "chr1", 100, 60, cig};
         EXPECT_EQ(aligned_segment.get_query_length(), 0);
     }
+
+    // all coordinates: 5H10S20M3D5I2N15M8S4H
+    {
+        std::vector<seqan3::cigar> cig = {{5, 'H'_cigar_operation}, {10, 'S'_cigar_operation},
+                                          {20, 'M'_cigar_operation}, {3, 'D'_cigar_operation},
+                                          {5, 'I'_cigar_operation}, {2, 'N'_cigar_operation},
+                                          {15, 'M'_cigar_operation}, {8, 'S'_cigar_operation},
+                                          {4, 'H'_cigar_operation}};
+        AlignedSegment aligned_segment = {strand::forward, "chr1", 100, 60, cig};
+        EXPECT_EQ(aligned_segment.get_reference_start(), 100);
+        EXPECT_EQ(aligned_segment.get_reference_end(), 139);
+        EXPECT_EQ(aligned_segment.get_left_soft_clip(), 10);
+        EXPECT_EQ(aligned_segment.get_right_soft_clip(), 8);
+        EXPECT_EQ(aligned_segment.get_query_length(), 58);
+        EXPECT_EQ(aligned_segment.get_query_start(), 10);
+        EXPECT_EQ(aligned_segment.get_query_end(), 50);
+
+        aligned_segment = {strand::reverse, "chr1", 100, 60, cig};
+        EXPECT_EQ(aligned_segment.get_query_start(), 8);
+        EXPECT_EQ(aligned_segment.get_query_end(), 48);
+    }
+
+    // only soft clips
+    {
+        std::vector<seqan3::cigar> cig = {{10, 'S'_cigar_operation}, {3, 'D'_cigar_operation},
+                                          {8, 'S'_cigar_operation}};
+        AlignedSegment aligned_segment = {strand::forward, "chr1", 100, 60, cig};
+        EXPECT_EQ(aligned_segment.get_reference_end(), 102);
+        EXPECT_EQ(aligned_segment.get_left_soft_clip(), 18);
+        EXPECT_EQ(aligned_segment.get_right_soft_clip(), 18);
+        EXPECT_EQ(aligned_segment.get_query_length(), 18);
+    }
+}
+
+/* tests for alignment_index */
+
+TEST(structures, alignment_index)
+{
+    std::filesystem::path const index_file_path = std::filesystem::temp_directory_path() / "iGenVar_index_test.igvi";
+    {
+        AlignmentIndexBuilder index_builder{3};
+        index_builder.add(0, 100, 200, 10);
+        index_builder.add(0, 150, 16500, 20);   // overlaps the windows 0 and 1
+        index_builder.add(0, 16400, 16450, 25); // not the first record of window 1
+        index_builder.add(0, 40000, 40100, 30); // window 2
+        index_builder.add(0, 70000, 70010, 35); // window 4, window 3 is empty
+        index_builder.add(2, 5, 10, 40);
+        index_builder.write(index_file_path);
+    }
+
+    AlignmentIndex const index{index_file_path};
+    ASSERT_EQ(index.size(), 3u);
+    EXPECT_TRUE(std::ranges::equal(index.windows(0), std::vector<int64_t>{10, 20, 30, -1, 35}));
+    EXPECT_TRUE(index.windows(1).empty());
+    EXPECT_TRUE(std::ranges::equal(index.windows(2), std::vector<int64_t>{40}));
+
+    EXPECT_EQ(index.first_overlap(0, 0, 100), 10);
+    EXPECT_EQ(index.first_overlap(0, 16384, 16400), 20);
+    EXPECT_EQ(index.first_overlap(0, 20000, 40000), 20);
+    EXPECT_EQ(index.first_overlap(0, 50000, 60000), -1);
+    EXPECT_EQ(index.first_overlap(0, 50000, 70000), 35);
+    EXPECT_EQ(index.first_overlap(0, 90000, 100000), -1);
+    EXPECT_EQ(index.first_overlap(1, 0, 1000), -1);
+    EXPECT_EQ(index.first_overlap(2, 0, 1000), 40);
+    EXPECT_EQ(index.first_overlap(3, 0, 1000), -1);
+
+    // A changed header or window does not match the checksum anymore.
+    for (std::streamoff const position : {24, 24 + 6 * 8})
+    {
+        std::fstream index_file{index_file_path, std::ios_base::binary | std::ios_base::in | std::ios_base::out};
+        index_file.seekg(position);
+        char const original = index_file.get();
+        index_file.seekp(position);
+        index_file.put(original + 1);
+        index_file.close();
+        EXPECT_THROW(AlignmentIndex{index_file_path}, std::runtime_error);
+
+        index_file.open(index_file_path, std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+        index_file.seekp(position);
+        index_file.put(original);
+    }
+    std::filesystem::remove(index_file_path);
 }
 
 /* tests for method_enums */
@@ -102,6 +201,74 @@ TEST(structures, method_enums_refinement_methods)
     EXPECT_EQ(refinement_methods::sVirl_refinement_method, sVirl_refinement_method_mapping["2"]);
 }
 
+/* tests for genomic_region */
+
+TEST(structures, genomic_region_parse_region)
+{
+    EXPECT_EQ(parse_region("chr21:41,970,001-41980000"), (GenomicRegion{"chr21", 41970000, 41980000}));
+    EXPECT_EQ(parse_region("21:100"), (GenomicRegion{"chr21", 99, std::numeric_limits<int32_t>::max()}));
+    EXPECT_EQ(parse_region("chrX"), (GenomicRegion{"chrX", 0, std::numeric_limits<int32_t>::max()}));
+    EXPECT_EQ(parse_region("chr1:5-5"), (GenomicRegion{"chr1", 4, 5}));
+
+    EXPECT_THROW(parse_region(""), std::invalid_argument);
+    EXPECT_THROW(parse_region(":1-10"), std::invalid_argument);
+    EXPECT_THROW(parse_region("chr1:0-10"), std::invalid_argument);
+    EXPECT_THROW(parse_region("chr1:10-5"), std::invalid_argument);
+    EXPECT_THROW(parse_region("chr1:1-"), std::invalid_argument);
+    EXPECT_THROW(parse_region("chr1:a-10"), std::invalid_argument);
+}
+
+TEST(structures, genomic_region_read_regions_bed)
+{
+    std::filesystem::path const bed_file_path = std::filesystem::temp_directory_path() / "iGenVar_regions_test.bed";
+    {
+        std::ofstream bed_file{bed_file_path};
+        bed_file << "track name=test\n"
+                 << "chr1\t100\t200\tname\t0\t+\n"
+                 << "\n"
+                 << "2\t0\t50\n";
+    }
+    std::vector<GenomicRegion> const expected_regions{{"chr1", 100, 200}, {"chr2", 0, 50}};
+    EXPECT_EQ(read_regions_bed(bed_file_path), expected_regions);
+
+    {
+        std::ofstream bed_file{bed_file_path};
+        bed_file << "chr1\t200\t100\n";
+    }
+    EXPECT_THROW(read_regions_bed(bed_file_path), std::invalid_argument);
+    std::filesystem::remove(bed_file_path);
+}
+
+/* tests for interned_string */
+
+TEST(structures, interned_string)
+{
+    std::string const chr1{"chr1"};
+    InternedString const a{chr1};
+    InternedString const b{"chr1"};
+    InternedString const c{"chr10"};
+
+    // Equal strings share the pooled copy.
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(&a.get(), &b.get());
+    EXPECT_NE(a, c);
+    EXPECT_TRUE(a == chr1);
+    EXPECT_TRUE(c != chr1);
+    EXPECT_TRUE(b == "chr1");
+
+    // Lexicographic order like std::string.
+    EXPECT_TRUE(a < c);
+    EXPECT_FALSE(c < a);
+    EXPECT_FALSE(a < b);
+    EXPECT_TRUE(c < InternedString{"chr2"});
+
+    EXPECT_EQ(InternedString{}, InternedString{""});
+    EXPECT_EQ(InternedString{}.get(), std::string{});
+
+    std::string const converted = c;
+    EXPECT_EQ(converted, "chr10");
+}
+
 /* tests for junctions */
 
 TEST(structures, breakend_flip_orientation)
@@ -117,3 +284,239 @@ TEST(structures, breakend_flip_orientation)
     forward_breakend.flip_orientation();
     EXPECT_EQ(forward_breakend, reverse_breakend); // both are forward now
 }
+
+TEST(structures, junction_read_name)
+{
+    using seqan3::operator""_dna5;
+
+    // The junctions of a read share its name, a copy of a junction shares the name, too.
+    auto const read_name = std::make_shared<std::string const>("read1");
+    Junction const deletion{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 500, strand::forward},
+                            ""_dna5, 0, read_name};
+    Junction const insertion{Breakend{"chr1", 900, strand::forward}, Breakend{"chr1", 901, strand::forward},
+                             "ACGT"_dna5, 0, read_name};
+    Junction const copy = deletion;
+    EXPECT_EQ(&deletion.get_read_name(), read_name.get());
+    EXPECT_EQ(&insertion.get_read_name(), read_name.get());
+    EXPECT_EQ(&copy.get_read_name(), read_name.get());
+
+    // A read name given as a string is copied.
+    Junction const other{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 500, strand::forward},
+                         ""_dna5, 0, std::string{"read1"}};
+    EXPECT_EQ(other.get_read_name(), *read_name);
+    EXPECT_NE(&other.get_read_name(), read_name.get());
+
+    EXPECT_EQ(Junction{}.get_read_name(), std::string{});
+}
+
+/* tests for clusters */
+
+TEST(structures, cluster_statistics)
+{
+    using seqan3::operator""_dna5;
+
+    Cluster const cluster{{Junction{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 500, strand::forward},
+                                    "ACGT"_dna5, 2, "read1"},
+                           Junction{Breakend{"chr1", 103, strand::forward}, Breakend{"chr1", 502, strand::forward},
+                                    "ACGTAC"_dna5, 3, "read2"},
+                           Junction{Breakend{"chr1", 105, strand::forward}, Breakend{"chr1", 509, strand::forward},
+                                    ""_dna5, 0, "read3"}}};
+
+    EXPECT_EQ(3u, cluster.get_cluster_size());
+    EXPECT_EQ((Breakend{"chr1", 103, strand::forward}), cluster.get_average_mate1());
+    EXPECT_EQ((Breakend{"chr1", 504, strand::forward}), cluster.get_average_mate2());
+    EXPECT_EQ(2u, cluster.get_common_tandem_dup_count());
+    EXPECT_EQ(3u, cluster.get_average_inserted_sequence_size());
+
+    // A copy keeps the statistics.
+    Cluster const copy = cluster;
+    EXPECT_EQ(cluster.get_average_mate2(), copy.get_average_mate2());
+    EXPECT_FALSE(cluster < copy);
+    EXPECT_FALSE(copy < cluster);
+
+    // Junctions with different orientations can not be clustered together.
+    EXPECT_THROW((Cluster{{Junction{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 500, strand::forward},
+                                    ""_dna5, 0, "read1"},
+                           Junction{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 500, strand::reverse},
+                                    ""_dna5, 0, "read2"}}}),
+                 std::runtime_error);
+}
+
+/* tests for junction_dump */
+
+TEST(structures, junction_dump)
+{
+    using seqan3::operator""_dna5;
+
+    std::vector<Junction> const junctions{
+        Junction{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 500, strand::forward}, "ACGTNAC"_dna5, 2,
+                 "read1"},
+        Junction{Breakend{"chr1", 103, strand::forward}, Breakend{"chr1", 502, strand::forward}, ""_dna5, 0, "read2"},
+        Junction{Breakend{"chr1", 200, strand::reverse}, Breakend{"chr2", 50, strand::forward}, "TTG"_dna5, 0,
+                 "read1"}};
+    std::map<std::string, int32_t> const references_lengths{{"chr1", 1000}, {"chr2", 2000}};
+    std::filesystem::path const dump_file_path = std::filesystem::temp_directory_path() / "iGenVar_dump_test.igvd";
+
+    {
+        JunctionDumpWriter writer{dump_file_path, references_lengths, dump_content::junctions};
+        for (Junction const & junction : junctions)
+            writer.add(junction);
+        EXPECT_THROW(writer.add(Cluster{}), std::logic_error);
+        writer.close();
+    }
+    {
+        JunctionDump const dump{dump_file_path};
+        EXPECT_EQ(dump.get_content(), dump_content::junctions);
+        EXPECT_EQ(dump.references_lengths(), references_lengths);
+        EXPECT_EQ(dump.junctions(), junctions);
+        EXPECT_EQ(dump.junction(2).get_read_name(), "read1");
+        // The junctions of the same read share its name.
+        EXPECT_EQ(&dump.junction(0).get_read_name(), &dump.junction(2).get_read_name());
+        EXPECT_TRUE(std::ranges::equal(dump.junction(2).get_inserted_sequence(), "TTG"_dna5));
+        EXPECT_TRUE(dump.clusters().empty());
+    }
+
+    std::vector<Cluster> const clusters{Cluster{{junctions[0], junctions[1]}}, Cluster{{junctions[2]}}};
+    {
+        JunctionDumpWriter writer{dump_file_path, references_lengths, dump_content::clusters};
+        for (Cluster const & cluster : clusters)
+            writer.add(cluster);
+    }
+    {
+        JunctionDump const dump{dump_file_path};
+        EXPECT_EQ(dump.get_content(), dump_content::clusters);
+        EXPECT_EQ(dump.size(), 3u);
+        EXPECT_EQ(dump.clusters(), clusters);
+        EXPECT_EQ(dump.clusters()[0].get_average_mate2(), clusters[0].get_average_mate2());
+    }
+
+    // A file of another format is rejected.
+    {
+        std::fstream dump_file{dump_file_path, std::ios_base::binary | std::ios_base::in | std::ios_base::out};
+        dump_file.seekp(8);
+        dump_file.put(2);
+    }
+    EXPECT_THROW(JunctionDump{dump_file_path}, std::runtime_error);
+    std::filesystem::remove(dump_file_path);
+    EXPECT_THROW(JunctionDump{dump_file_path}, std::runtime_error);
+}
+
+TEST(structures, junction_sorter)
+{
+    using seqan3::operator""_dna5;
+
+    // Forward and reverse junctions on chr1 in the order of a coordinate sorted alignment file, spilled in runs of three
+    // junctions. The split read alignment on chr2 adds the late junctions at chr1:5040 and chr1:170.
+    std::vector<Junction> const junctions{
+        Junction{Breakend{"chr1", 100, strand::forward}, Breakend{"chr1", 600, strand::forward}, ""_dna5, 0, "read1"},
+        Junction{Breakend{"chr1", 150, strand::reverse}, Breakend{"chr1", 700, strand::reverse}, ""_dna5, 0, "read2"},
+        Junction{Breakend{"chr1", 120, strand::forward}, Breakend{"chr1", 620, strand::forward}, ""_dna5, 0, "read3"},
+        Junction{Breakend{"chr1", 5000, strand::reverse}, Breakend{"chr1", 5600, strand::reverse}, ""_dna5, 0, "read4"},
+        Junction{Breakend{"chr1", 5000, strand::forward}, Breakend{"chr1", 5500, strand::forward}, ""_dna5, 0, "read5"},
+        Junction{Breakend{"chr1", 5080, strand::forward}, Breakend{"chr1", 5580, strand::forward}, ""_dna5, 0, "read6"},
+        Junction{Breakend{"chr2", 100, strand::forward}, Breakend{"chr2", 900, strand::forward}, ""_dna5, 0, "read7"},
+        Junction{Breakend{"chr1", 5040, strand::forward}, Breakend{"chr1", 5540, strand::forward}, ""_dna5, 0, "read8"},
+        Junction{Breakend{"chr1", 170, strand::reverse}, Breakend{"chr1", 720, strand::reverse}, ""_dna5, 0, "read8"},
+        Junction{Breakend{"chr1", 200, strand::forward}, Breakend{"chr2", 300, strand::forward}, ""_dna5, 0, "read9"}};
+    std::vector<Junction> sorted_junctions{junctions};
+    std::sort(sorted_junctions.begin(), sorted_junctions.end());
+    std::map<std::string, int32_t> const references_lengths{{"chr1", 10000}, {"chr2", 10000}};
+
+    for (size_t const junctions_per_run : {3, 100})
+    {
+        JunctionSorter sorter{references_lengths, junctions_per_run};
+        for (Junction junction : junctions)
+            sorter.add(std::move(junction));
+
+        // A batch of at least two junctions ends in front of another reference sequence, another orientation or a gap
+        // of more than 100 bp.
+        std::vector<std::vector<Junction>> batches{};
+        sorter.merge(100, 2, [&batches] (std::vector<Junction> & batch) { batches.push_back(batch); });
+        ASSERT_EQ(batches.size(), 4u) << "junctions per run: " << junctions_per_run;
+        EXPECT_EQ(batches[0], (std::vector<Junction>{sorted_junctions.begin(), sorted_junctions.begin() + 3}));
+        EXPECT_EQ(batches[1], (std::vector<Junction>{sorted_junctions.begin() + 3, sorted_junctions.begin() + 6}));
+        EXPECT_EQ(batches[1][1], junctions[7]); // the late junction joins its partition
+        EXPECT_EQ(batches[2], (std::vector<Junction>{sorted_junctions.begin() + 6, sorted_junctions.begin() + 8}));
+        EXPECT_EQ(batches[3], (std::vector<Junction>{sorted_junctions.begin() + 8, sorted_junctions.end()}));
+    }
+}
+
+/* tests for reference_genome */
+
+TEST(structures, reference_genome)
+{
+    using seqan3::operator""_dna5;
+
+    // A reference sequence of more than one page with 60 bases per line and one with lower case bases and CRLF.
+    std::string chr1{};
+    for (size_t i = 0; i < 20000; ++i)
+        chr1.push_back("ACGT"[(i * 7 + i / 13) % 4]);
+    std::filesystem::path const fasta_file_path = std::filesystem::temp_directory_path() / "iGenVar_genome_test.fa";
+    std::filesystem::path const index_file_path = fasta_file_path.string() + ".fai";
+    {
+        std::ofstream fasta_file{fasta_file_path, std::ios_base::binary};
+        fasta_file << ">chr1 description\n";
+        for (size_t i = 0; i < chr1.size(); i += 60)
+            fasta_file << chr1.substr(i, 60) << '\n';
+        fasta_file << ">chr2\r\nacgt\r\nnacg\r\n";
+    }
+    auto dna5 = [] (std::string const & bases)
+    {
+        seqan3::dna5_vector sequence{};
+        for (char const base : bases)
+            sequence.push_back(seqan3::assign_char_to(base, seqan3::dna5{}));
+        return sequence;
+    };
+    auto expect_bases = [&] (ReferenceGenome const & genome)
+    {
+        ReferenceGenomeCache cache{genome};
+        seqan3::dna5_vector sequence{};
+        cache.append_bases("chr1", 16300, 16400, sequence); // across lines and pages
+        EXPECT_TRUE(std::ranges::equal(sequence, dna5(chr1.substr(16300, 100))));
+        sequence.clear();
+        cache.append_bases("chr1", -2, 3, sequence);
+        EXPECT_TRUE(std::ranges::equal(sequence, dna5("NN" + chr1.substr(0, 3))));
+        sequence.clear();
+        cache.append_bases("chr1", 19998, 20002, sequence);
+        EXPECT_TRUE(std::ranges::equal(sequence, dna5(chr1.substr(19998) + "NN")));
+        sequence.clear();
+        cache.append_bases("chr2", 2, 7, sequence);
+        EXPECT_TRUE(std::ranges::equal(sequence, "GTNAC"_dna5));
+        cache.append_bases("chr3", 0, 2, sequence);
+        EXPECT_TRUE(std::ranges::equal(sequence, "GTNACNN"_dna5));
+    };
+
+    // Without an index, the index is built from the FASTA file.
+    std::filesystem::remove(index_file_path);
+    {
+        ReferenceGenome const genome{fasta_file_path};
+        ASSERT_NE(genome.find("chr1"), nullptr);
+        EXPECT_EQ(genome.find("chr1")->length, 20000u);
+        EXPECT_EQ(genome.find("chr2")->line_width, 6u);
+        EXPECT_EQ(genome.find("chr3"), nullptr);
+        expect_bases(genome);
+    }
+
+    // With an index as written by `samtools faidx`.
+    {
+        std::ofstream index_file{index_file_path};
+        index_file << "chr1\t20000\t18\t60\t61\n"
+                   << "chr2\t8\t" << 18 + 20334 + 7 << "\t4\t6\n";
+    }
+    expect_bases(ReferenceGenome{fasta_file_path});
+    {
+        std::ofstream index_file{index_file_path};
+        index_file << "chr1\t30000\t18\t60\t61\n";
+    }
+    EXPECT_THROW(ReferenceGenome{fasta_file_path}, std::runtime_error);
+    std::filesystem::remove(index_file_path);
+
+    // The lines of a sequence have to be of equal length.
+    {
+        std::ofstream fasta_file{fasta_file_path};
+        fasta_file << ">chr1\nACGT\nAC\nACGT\n";
+    }
+    EXPECT_THROW(ReferenceGenome{fasta_file_path}, std::runtime_error);
+    std::filesystem::remove(fasta_file_path);
+    EXPECT_THROW(ReferenceGenome{fasta_file_path}, std::runtime_error);
+}
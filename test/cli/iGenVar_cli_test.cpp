@@ -4,8 +4,8 @@
 #include "cli_test.hpp"
 
 std::string const default_alignment_long_reads_file_path = "simulated.minimap2.hg19.coordsorted_cutoff.sam";
-std::filesystem::path const long_reads_bamit_path{DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam.bit"};
-std::filesystem::path const short_reads_bamit_path{DATADIR"paired_end_mini_example.sam.bit"};
+std::filesystem::path const long_reads_index_path{DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam.igvi"};
+std::filesystem::path const short_reads_index_path{DATADIR"paired_end_mini_example.sam.igvi"};
 std::string const default_genome_file_path = "mini_example_reference.fasta";
 std::string const vcf_out_file_path = "variants_file_out.vcf";
 std::string const junctions_out_file_path = "junctions_file_out.txt";
@@ -40,19 +40,45 @@ std::string const help_page_part_1
     "          Nanopore, ...). Default: \"\". The input file must exist and read\n"
     "          permissions must be granted. Valid file extensions are: [sam, bam].\n"
     "    -g, --input_genome (std::filesystem::path)\n"
-    "          Input the sequence of the reference genome. Default: \"\". The input\n"
-    "          file must exist and read permissions must be granted. Valid file\n"
-    "          extensions are: [embl, fasta, fa, fna, ffn, faa, frn, fas, fastq,\n"
-    "          fq, genbank, gb, gbk, sam].\n"
+    "          Input the sequence of the reference genome in FASTA format. It fills\n"
+    "          the REF column of the VCF output and is read by random access with\n"
+    "          its FASTA index (.fai), which is built on the fly if it is missing.\n"
+    "          It does not change the detection of the variants. Default: \"\". The\n"
+    "          input file must exist and read permissions must be granted. Valid\n"
+    "          file extensions are: [fasta, fa, fna, ffn, faa, frn, fas].\n"
+    "    --snp_indel\n"
+    "          If you set this flag, the active regions of SNPs and indels are\n"
+    "          detected in the short read file instead of its junctions, thus no\n"
+    "          SVs of the short reads are output. Only available for short read\n"
+    "          files.\n"
+    "    --input_junctions (std::filesystem::path)\n"
+    "          Input the junctions from a binary dump (.igvd) of --junctions or\n"
+    "          --clusters of a previous run instead of detecting them in alignment\n"
+    "          files. The junctions are clustered and output with the current\n"
+    "          parameters. Default: \"\". The input file must exist and read\n"
+    "          permissions must be granted. Valid file extensions are: [igvd].\n"
     "    -o, --output (std::filesystem::path)\n"
     "          The path of the vcf output file. If no path is given, will output to\n"
-    "          standard output. Default: \"\". Write permissions must be granted.\n"
-    "          Valid file extensions are: [vcf].\n"
+    "          standard output. A path ending in .gz is written compressed in the\n"
+    "          BGZF format together with a tabix index (.tbi or .csi for very long\n"
+    "          reference sequences), a path ending in .bcf is written in the binary\n"
+    "          BCF format. Default: \"\". Write permissions must be granted. Valid\n"
+    "          file extensions are: [vcf, vcf.gz, bcf].\n"
+    "    --region (List of std::string)\n"
+    "          Restrict the detection to a region in the format chr:start-end,\n"
+    "          chr:start or chr (1-based, inclusive). Can be given multiple times.\n"
+    "          The alignments are read via the index of the alignment file (.igvi),\n"
+    "          which is created if it does not exist. Default: [].\n"
+    "    --regions_bed (std::filesystem::path)\n"
+    "          Restrict the detection to the regions of a BED file, like --region.\n"
+    "          Default: \"\". The input file must exist and read permissions must be\n"
+    "          granted. Valid file extensions are: [bed].\n"
     "    -s, --vcf_sample_name (std::string)\n"
     "          Specify your sample name for the vcf header line. Default: MYSAMPLE.\n"
     "    -t, --threads (unsigned 64 bit integer)\n"
-    "          Specify the number of decompression threads used for reading BAM\n"
-    "          files. Default: 1.\n"
+    "          Specify the number of threads used for decompressing BAM files, for\n"
+    "          analysing long read alignments, for clustering and for formatting\n"
+    "          the VCF records. Default: 1.\n"
     "    -v, --verbose\n"
     "          If you set this flag, we provide additional details about what\n"
     "          iGenVar does. The detailed output is printed in the standard error.\n"
@@ -82,12 +108,14 @@ std::string const help_page_advanced
 {
     "    -a, --junctions (std::filesystem::path)\n"
     "          The path of the optional junction output file. If no path is given,\n"
-    "          junctions will not be output. Default: \"\". Write permissions must be\n"
-    "          granted.\n"
+    "          junctions will not be output. A path ending in .igvd is written in a\n"
+    "          binary format, which can be read by --input_junctions. Default: \"\".\n"
+    "          Write permissions must be granted.\n"
     "    -b, --clusters (std::filesystem::path)\n"
     "          The path of the optional cluster output file. If no path is given,\n"
-    "          clusters will not be output. Default: \"\". Write permissions must be\n"
-    "          granted.\n"
+    "          clusters will not be output. A path ending in .igvd is written in a\n"
+    "          binary format, which can be read by --input_junctions. Default: \"\".\n"
+    "          Write permissions must be granted.\n"
     "    -d, --method (List of detection_methods)\n"
     "          Choose the detection method(s) to be used. Value must be one of\n"
     "          (method name or number)\n"
@@ -130,15 +158,25 @@ std::string const help_page_advanced
     "    -w, --hierarchical_clustering_cutoff (double)\n"
     "          Specify the distance cutoff for the hierarchical clustering. This\n"
     "          value needs to be non-negative. Default: 0.3.\n"
+    "    --approximate_large_partitions\n"
+    "          If you set this flag, the hierarchical clustering (1) clusters\n"
+    "          groups of more than 200 nearby junctions by an approximate average\n"
+    "          linkage instead of their full distance matrix, whose memory grows\n"
+    "          quadratically with the size of the group. The clusters can differ\n"
+    "          from the exact average linkage.\n"
+    "    --streaming\n"
+    "          If you set this flag, the long read file is processed in streaming\n"
+    "          mode: instead of storing all junctions in memory, the junctions are\n"
+    "          spilled to a temporary file in sorted runs and clustered in batches\n"
+    "          of whole partitions after the file has been read. The voting\n"
+    "          clustering method (3) can cluster differently at the borders of the\n"
+    "          batches. Not available for short read files.\n"
 };
 
 std::string const expected_err_default_no_err_1
 {
     "Detect junctions in long reads...\n"
     "The read depth method for long reads is not yet implemented.\n"
-    "The read depth method for long reads is not yet implemented.\n"
-    "The read depth method for long reads is not yet implemented.\n"
-    "The read depth method for long reads is not yet implemented.\n"
     "Start clustering...\n"
 };
 
@@ -202,14 +240,11 @@ TEST_F(iGenVar_cli_test, test_verbose_option)
     std::string const expected_err
     {
         "Detect junctions in long reads...\n"
-        "INS: chr21\t41972615\tForward\tchr21\t41972616\tForward\t1681\t0\tm2257/8161/CCS\n"
         "The read depth method for long reads is not yet implemented.\n"
+        "INS: chr21\t41972615\tForward\tchr21\t41972616\tForward\t1681\t0\tm2257/8161/CCS\n"
         "BND: chr21\t41972615\tReverse\tchr22\t17458415\tReverse\t0\t0\tm41327/11677/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "BND: chr21\t41972616\tReverse\tchr22\t17458416\tReverse\t0\t0\tm21263/13017/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "BND: chr21\t41972616\tReverse\tchr22\t17458416\tReverse\t0\t0\tm38637/7161/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "Start clustering...\n"
     };
     EXPECT_EQ(result.exit_code, 0);
@@ -294,11 +329,12 @@ TEST_F(iGenVar_cli_test, test_intermediate_result_output)
     EXPECT_NE(buffer2.str(), std::string{});
 }
 
-TEST_F(iGenVar_cli_test, test_genome_input)
+TEST_F(iGenVar_cli_test, test_snp_indel_detection)
 {
     cli_test_result result = execute_app("iGenVar",
                                          "-g", data(default_genome_file_path),
-                                         "-i", data("single_end_mini_example.sam"));
+                                         "-i", data("single_end_mini_example.sam"),
+                                         "--snp_indel");
     std::string const expected_err =
     {
         "Detect SNPs and indels in short reads...\n"
@@ -489,16 +525,9 @@ TEST_F(iGenVar_cli_test, self_balancing_binary_tree)
     cli_test_result result = execute_app("iGenVar",
                                          "-j", data(default_alignment_long_reads_file_path),
                                          "--clustering_method self_balancing_binary_tree");
-    std::string const expected_err
-    {
-        "The self-balancing binary tree clustering method is not yet implemented.\n"
-        "Done with clustering. Found 0 junction clusters.\n"
-        "No refinement was selected.\n"
-        "Detected 0 SVs.\n"
-    };
     EXPECT_EQ(result.exit_code, 0);
     EXPECT_EQ(result.out.erase(filedate_position_1, 19), expected_res_default); // erase the filedate
-    EXPECT_EQ(result.err, expected_err_default_no_err_1 + expected_err);
+    EXPECT_EQ(result.err, expected_err_default_no_err_1 + expected_err_default_no_err_2);
 }
 
 TEST_F(iGenVar_cli_test, candidate_selection_based_on_voting)
@@ -506,16 +535,9 @@ TEST_F(iGenVar_cli_test, candidate_selection_based_on_voting)
     cli_test_result result = execute_app("iGenVar",
                                          "-j", data(default_alignment_long_reads_file_path),
                                          "--clustering_method candidate_selection_based_on_voting");
-    std::string const expected_err
-    {
-        "The candidate selection based on voting clustering method is not yet implemented.\n"
-        "Done with clustering. Found 0 junction clusters.\n"
-        "No refinement was selected.\n"
-        "Detected 0 SVs.\n"
-    };
     EXPECT_EQ(result.exit_code, 0);
     EXPECT_EQ(result.out.erase(filedate_position_1, 19), expected_res_default); // erase the filedate
-    EXPECT_EQ(result.err, expected_err_default_no_err_1 + expected_err);
+    EXPECT_EQ(result.err, expected_err_default_no_err_1 + expected_err_default_no_err_2);
 }
 
 // Refinement methods:
@@ -562,6 +584,75 @@ TEST_F(iGenVar_cli_test, sVirl_refinement_method)
     EXPECT_EQ(result.err, expected_err_default_no_err_1 + expected_err);
 }
 
+// Streaming mode:
+
+TEST_F(iGenVar_cli_test, streaming)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data(default_alignment_long_reads_file_path),
+                                         "--min_qual 1 --streaming");
+    std::string const expected_err
+    {
+        "Detect and cluster junctions in long reads in streaming mode...\n"
+        "The read depth method for long reads is not yet implemented.\n"
+        "Done with clustering. Found 2 junction clusters.\n"
+        "No refinement was selected.\n"
+        "Detected 1 SVs.\n"
+    };
+    std::string const expected_res
+    {
+        "chr21\t41972616\t.\tN\t<INS>\t1\tPASS\tEND=41972616;SVLEN=1681;iGenVar_SVLEN=1681;SVTYPE=INS\tGT\t./.\n"
+    };
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out.erase(filedate_position_1, 19), expected_res_default + expected_res);
+    EXPECT_EQ(result.err, expected_err);
+}
+
+TEST_F(iGenVar_cli_test, fail_snp_indel_long_reads)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data(default_alignment_long_reads_file_path),
+                                         "--snp_indel");
+    std::string const expected_err
+    {
+        "[Error] The detection of SNPs and indels is only available for short read files (-i).\n"
+    };
+    EXPECT_EQ(result.exit_code, 65280);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, expected_err);
+}
+
+TEST_F(iGenVar_cli_test, fail_streaming_short_reads)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-i", data("paired_end_mini_example.sam"),
+                                         "--streaming");
+    std::string const expected_err
+    {
+        "[Error] The streaming mode is only available for long read files (-j).\n"
+    };
+    EXPECT_EQ(result.exit_code, 65280);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, expected_err);
+}
+
+// Regions:
+
+TEST_F(iGenVar_cli_test, fail_invalid_region)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data(default_alignment_long_reads_file_path),
+                                         "--region chr21:200-100");
+    std::string const expected_err
+    {
+        "[Error] Invalid region 'chr21:200-100'. The format is chr:start-end, chr:start or chr with 1-based "
+        "coordinates and start <= end.\n"
+    };
+    EXPECT_EQ(result.exit_code, 65280);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, expected_err);
+}
+
 // Other argument tests
 
 TEST_F(iGenVar_cli_test, fail_unknown_option)
@@ -693,7 +784,7 @@ TEST_F(iGenVar_cli_test, dataset_paired_end_mini_example)
     };
     EXPECT_EQ(result.err, expected_err);
 
-    std::filesystem::remove(short_reads_bamit_path);
+    std::filesystem::remove(short_reads_index_path);
 }
 
 TEST_F(iGenVar_cli_test, dataset_single_end_mini_example)
@@ -743,5 +834,5 @@ TEST_F(iGenVar_cli_test, dataset_short_and_long_read_mini_example)
                                      std::istreambuf_iterator<char>());
     EXPECT_EQ(result.err, output_err_str);
 
-    std::filesystem::remove(short_reads_bamit_path);
+    std::filesystem::remove(short_reads_index_path);
 }
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <random>       // for std::mt19937
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+#include "fastcluster.h"                                            // for hclust_fast and cutree_cdist
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for bounded_average_linkage
+#include "structures/junction.hpp"                                  // for class Junction
+
+/* Generates the condensed distance matrix of a partition of deletions, which are spread over the given amount of SV
+ * loci. With a single locus the partition forms one large cluster, with many loci it splits
+ * into many small clusters. The result is identical for the same arguments, as the random generator uses the default
+ * seed.
+ */
+std::vector<double> generate_distance_matrix(size_t const amount, size_t const loci)
+{
+    std::mt19937 generator{};
+    std::uniform_int_distribution<size_t> locus_distribution(0, loci - 1);
+    std::uniform_int_distribution<int32_t> jitter_distribution(-20, 20);
+
+    std::vector<Junction> junctions{};
+    junctions.reserve(amount);
+    for (size_t i = 0; i < amount; ++i)
+    {
+        // The loci are 500 bp apart, such that the distance between junctions of different loci exceeds the cutoff.
+        int32_t const locus = locus_distribution(generator);
+        int32_t const position = 100000 + locus * 500 + jitter_distribution(generator);
+        int32_t const size = 1000 + jitter_distribution(generator);
+        junctions.emplace_back(Breakend{"chr1", position, strand::forward},
+                               Breakend{"chr1", position + size, strand::forward},
+                               seqan3::dna5_vector{}, 0, "read_" + std::to_string(i));
+    }
+
+    std::vector<double> distances{};
+    distances.reserve(amount * (amount - 1) / 2);
+    for (size_t i = 0; i < amount; ++i)
+        for (size_t j = i + 1; j < amount; ++j)
+            distances.push_back(junction_distance(junctions[i], junctions[j]));
+    return distances;
+}
+
+// Complete dendrogram by the library hclust, which is cut at the clustering cutoff afterwards.
+void average_linkage_fastcluster(benchmark::State & state)
+{
+    size_t const amount = state.range(0);
+    std::vector<double> const distances = generate_distance_matrix(amount, state.range(1));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<double> distmat{distances};
+        state.ResumeTiming();
+
+        std::vector<int> merge(2 * (amount - 1));
+        std::vector<double> height(amount - 1);
+        hclust_fast(amount, distmat.data(), HCLUST_METHOD_AVERAGE, merge.data(), height.data());
+        std::vector<int> labels(amount);
+        cutree_cdist(amount, merge.data(), height.data(), 0.3, labels.data());
+        benchmark::DoNotOptimize(labels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * amount);
+}
+
+// Average linkage, which stops at the clustering cutoff.
+void average_linkage_bounded(benchmark::State & state)
+{
+    size_t const amount = state.range(0);
+    std::vector<double> const distances = generate_distance_matrix(amount, state.range(1));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<double> distmat{distances};
+        state.ResumeTiming();
+
+        std::vector<size_t> labels = bounded_average_linkage(amount, distmat, 0.3);
+        benchmark::DoNotOptimize(labels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * amount);
+}
+
+// Arguments: the size of the partition and the amount of SV loci in the partition.
+BENCHMARK(average_linkage_fastcluster)->Args({50, 1})->Args({200, 1})->Args({200, 10})->Args({200, 100});
+BENCHMARK(average_linkage_bounded)->Args({50, 1})->Args({200, 1})->Args({200, 10})->Args({200, 100});
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>   // for std::filesystem::file_size
+#include <random>       // for std::mt19937
+
+#include <seqan3/alphabet/cigar/cigar.hpp>
+#include <seqan3/alphabet/views/char_to.hpp>
+
+#include "modules/sv_detection_methods/analyze_cigar_method.hpp"    // for the cigar string method
+#include "structures/query_sequence.hpp"                            // for query_sequence_t
+#include "variant_detection/variant_detection.hpp"                  // for detect_junctions_in_long_reads_sam_file
+
+using seqan3::operator""_cigar_operation;
+
+/* A long read of 20 kb as it is stored in the SEQ field of a SAM file and an alignment with a few small indels, which
+ * are all shorter than the minimum variant length. This is the common case, in which no junction is found.
+ */
+std::string const read_string = []()
+{
+    std::string read(20000, 'A');
+    std::mt19937 generator{};
+    std::uniform_int_distribution<size_t> base_distribution(0, 3);
+    for (char & base : read)
+        base = "ACGT"[base_distribution(generator)];
+    return read;
+}();
+
+std::vector<seqan3::cigar> const read_cigar = []()
+{
+    std::vector<seqan3::cigar> cigar{{100, 'S'_cigar_operation}};
+    for (size_t i = 0; i < 98; ++i)
+    {
+        cigar.push_back({195, 'M'_cigar_operation});
+        cigar.push_back({5, (i % 2 == 0) ? 'I'_cigar_operation : 'D'_cigar_operation});
+    }
+    cigar.push_back({100, 'M'_cigar_operation});
+    cigar.push_back({100, 'S'_cigar_operation});
+    return cigar;
+}();
+
+// Reads the SEQ field into the given sequence type and analyses the CIGAR string.
+template <typename sequence_t>
+void read_and_analyze_cigar(benchmark::State & state)
+{
+    using alphabet_t = std::ranges::range_value_t<sequence_t>;
+    std::vector<Junction> junctions{};
+
+    for (auto _ : state)
+    {
+        sequence_t sequence{};
+        for (char const base : read_string)
+            sequence.push_back(seqan3::assign_char_to(base, alphabet_t{}));
+        analyze_cigar("read", "chr1", 100000, read_cigar, sequence, junctions, 30);
+        benchmark::DoNotOptimize(junctions.data());
+    }
+    state.SetBytesProcessed(state.iterations() * read_string.size());
+}
+
+void detect_junctions_in_long_reads_file(benchmark::State & state)
+{
+    cmd_arguments args{};
+    args.alignment_long_reads_file_path = DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam";
+    args.methods = {cigar_string, split_read};
+
+    for (auto _ : state)
+    {
+        std::vector<Junction> junctions{};
+        std::map<std::string, int32_t> references_lengths{};
+        detect_junctions_in_long_reads_sam_file(junctions, references_lengths, args);
+        benchmark::DoNotOptimize(junctions.data());
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(args.alignment_long_reads_file_path));
+}
+
+BENCHMARK_TEMPLATE(read_and_analyze_cigar, seqan3::dna5_vector);
+BENCHMARK_TEMPLATE(read_and_analyze_cigar, query_sequence_t);
+BENCHMARK(detect_junctions_in_long_reads_file);
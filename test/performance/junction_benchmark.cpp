@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>    // for std::sort
+#include <random>       // for std::mt19937
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+#include "modules/clustering/candidate_selection_based_on_voting_method.hpp" // for the voting clustering method
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
+#include "structures/junction.hpp"                                  // for class Junction
+
+/* Generates junctions that resemble the output of the detection step: mostly deletions and insertions that pile up at
+ * a limited number of SV loci on a few chromosomes, plus some inter-chromosomal junctions. The result is identical for
+ * the same amount, as the random generator uses the default seed.
+ */
+std::vector<Junction> generate_junctions(size_t const amount)
+{
+    std::vector<std::string> const chromosomes{"chr1", "chr2", "chr3", "chr10", "chrX"};
+    std::mt19937 generator{};
+    std::uniform_int_distribution<size_t> chromosome_distribution(0, chromosomes.size() - 1);
+    std::uniform_int_distribution<int32_t> locus_distribution(0, 10000);
+    std::uniform_int_distribution<int32_t> jitter_distribution(-20, 20);
+    std::uniform_int_distribution<int32_t> size_distribution(30, 2000);
+    std::uniform_int_distribution<int> type_distribution(0, 9);
+    std::uniform_int_distribution<int> base_distribution(0, 3);
+
+    std::vector<Junction> junctions{};
+    junctions.reserve(amount);
+    for (size_t i = 0; i < amount; ++i)
+    {
+        std::string const & chromosome = chromosomes[chromosome_distribution(generator)];
+        // Many reads support the same locus.
+        int32_t const locus = locus_distribution(generator) * 1000;
+        int32_t const position = locus + jitter_distribution(generator);
+        int32_t const size = size_distribution(generator) + (locus / 1000) % 50;
+        std::string const read_name = "read_" + std::to_string(i);
+        int const type = type_distribution(generator);
+
+        if (type < 5) // deletion
+        {
+            junctions.emplace_back(Breakend{chromosome, position, strand::forward},
+                                   Breakend{chromosome, position + size, strand::forward},
+                                   seqan3::dna5_vector{}, 0, read_name);
+        }
+        else if (type < 9) // insertion
+        {
+            seqan3::dna5_vector inserted_sequence(size);
+            for (seqan3::dna5 & base : inserted_sequence)
+                base.assign_rank(base_distribution(generator));
+            junctions.emplace_back(Breakend{chromosome, position, strand::forward},
+                                   Breakend{chromosome, position + 1, strand::forward},
+                                   inserted_sequence, 0, read_name);
+        }
+        else // translocation
+        {
+            std::string const & other_chromosome = chromosomes[chromosome_distribution(generator)];
+            junctions.emplace_back(Breakend{chromosome, position, strand::forward},
+                                   Breakend{other_chromosome, locus / 2 + jitter_distribution(generator), strand::reverse},
+                                   seqan3::dna5_vector{}, 0, read_name);
+        }
+    }
+    return junctions;
+}
+
+void sort_junctions(benchmark::State & state)
+{
+    std::vector<Junction> const junctions = generate_junctions(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<Junction> to_sort{junctions};
+        state.ResumeTiming();
+
+        std::sort(to_sort.begin(), to_sort.end());
+        benchmark::DoNotOptimize(to_sort.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void compare_junctions(benchmark::State & state)
+{
+    std::vector<Junction> const junctions = generate_junctions(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t smaller = 0;
+        for (size_t i = 1; i < junctions.size(); ++i)
+            smaller += (junctions[i - 1] < junctions[i]) + (junctions[i - 1] == junctions[i]);
+        benchmark::DoNotOptimize(smaller);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void junction_distance_matrix(benchmark::State & state)
+{
+    // A single partition: all junctions describe deletions at the same locus.
+    std::vector<Junction> junctions{};
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        junctions.emplace_back(Breakend{"chr1", 100000 + static_cast<int32_t>(i % 40), strand::forward},
+                               Breakend{"chr1", 101000 + static_cast<int32_t>(i % 60), strand::forward},
+                               seqan3::dna5_vector{}, 0, "read_" + std::to_string(i));
+    }
+
+    for (auto _ : state)
+    {
+        double sum = 0;
+        for (size_t i = 0; i < junctions.size(); ++i)
+            for (size_t j = i + 1; j < junctions.size(); ++j)
+                sum += junction_distance(junctions[i], junctions[j]);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (state.range(0) - 1) / 2);
+}
+
+void hierarchical_clustering(benchmark::State & state)
+{
+    std::vector<Junction> junctions = generate_junctions(state.range(0));
+    std::sort(junctions.begin(), junctions.end());
+
+    for (auto _ : state)
+    {
+        std::vector<Cluster> clusters = hierarchical_clustering_method(junctions, 50, 0.3);
+        benchmark::DoNotOptimize(clusters.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void voting_clustering(benchmark::State & state)
+{
+    std::vector<Junction> junctions = generate_junctions(state.range(0));
+    std::sort(junctions.begin(), junctions.end());
+
+    for (auto _ : state)
+    {
+        std::vector<Cluster> clusters = candidate_selection_based_on_voting_method(junctions, 0.3);
+        benchmark::DoNotOptimize(clusters.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(sort_junctions)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(compare_junctions)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(junction_distance_matrix)->Arg(50)->Arg(200);
+BENCHMARK(hierarchical_clustering)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(voting_clustering)->RangeMultiplier(10)->Range(1000, 100000);
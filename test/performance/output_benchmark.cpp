@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>    // for std::sort
+#include <filesystem>   // for std::filesystem::temp_directory_path and std::filesystem::file_size
+
+#include <bio/var_io/reader.hpp>
+
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for hierarchical_clustering_method
+#include "variant_detection/variant_detection.hpp"                  // for detect_junctions_in_long_reads_sam_file
+#include "variant_detection/variant_output.hpp"                     // for find_and_output_variants
+
+/* The clusters of the long read test data, which are detected and clustered once with the default parameters. The
+ * minimum quality is lowered to 1 supporting read, such that every cluster with a valid SV is written.
+ */
+struct long_read_clusters
+{
+    cmd_arguments args{};
+    std::map<std::string, int32_t> references_lengths{};
+    std::vector<Cluster> clusters{};
+
+    long_read_clusters()
+    {
+        args.alignment_long_reads_file_path = DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam";
+        args.methods = {cigar_string, split_read};
+        args.min_qual = 1;
+
+        std::vector<Junction> junctions{};
+        detect_junctions_in_long_reads_sam_file(junctions, references_lengths, args);
+        std::sort(junctions.begin(), junctions.end());
+        clusters = hierarchical_clustering_method(std::move(junctions),
+                                                  args.partition_max_distance,
+                                                  args.hierarchical_clustering_cutoff);
+    }
+};
+
+long_read_clusters & get_long_read_clusters()
+{
+    static long_read_clusters data{};
+    return data;
+}
+
+std::filesystem::path output_path(std::string const & extension)
+{
+    return std::filesystem::temp_directory_path()/("output_benchmark" + extension);
+}
+
+// Detects the variants of the clusters and writes them in the format of the given file extension.
+void write_variants(benchmark::State & state, std::string const & extension)
+{
+    long_read_clusters & data = get_long_read_clusters();
+
+    for (auto _ : state)
+        find_and_output_variants(data.references_lengths, data.clusters, data.args, output_path(extension));
+
+    state.SetItemsProcessed(state.iterations() * data.clusters.size());
+    state.counters["file_size"] = std::filesystem::file_size(output_path(extension));
+    std::filesystem::remove(output_path(extension));
+    std::filesystem::remove(output_path(extension + ".tbi"));
+}
+
+// Reads the records of the output like a downstream tool, which parses the INFO fields.
+void read_variants(benchmark::State & state, std::string const & extension)
+{
+    long_read_clusters & data = get_long_read_clusters();
+    find_and_output_variants(data.references_lengths, data.clusters, data.args, output_path(extension));
+
+    size_t amount_records = 0;
+    for (auto _ : state)
+    {
+        bio::var_io::reader reader{output_path(extension)};
+        for (auto & record : reader)
+        {
+            benchmark::DoNotOptimize(record.info());
+            ++amount_records;
+        }
+    }
+    state.SetItemsProcessed(amount_records);
+    std::filesystem::remove(output_path(extension));
+}
+
+BENCHMARK_CAPTURE(write_variants, vcf, std::string{".vcf"});
+BENCHMARK_CAPTURE(write_variants, vcf_gz, std::string{".vcf.gz"});
+BENCHMARK_CAPTURE(write_variants, bcf, std::string{".bcf"});
+BENCHMARK_CAPTURE(read_variants, vcf, std::string{".vcf"});
+BENCHMARK_CAPTURE(read_variants, bcf, std::string{".bcf"});
@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "modules/sv_detection_methods/analyze_split_read_method.hpp"   // for retrieve_aligned_segments
+
+/* The SA tag of a chimeric read with the given amount of supplementary alignments. Half of the reference names lack
+ * the "chr" prefix, as it is common for the reference genomes of the GRC.
+ */
+std::string generate_sa_tag(size_t const amount_segments)
+{
+    std::string sa_tag{};
+    for (size_t i = 0; i < amount_segments; ++i)
+    {
+        sa_tag += (i % 2 == 0 ? "chr" : "") + std::to_string(i % 22 + 1) + ","
+                + std::to_string(1000000 + 12345 * i) + ","
+                + (i % 3 == 0 ? "-" : "+") + ","
+                + std::to_string(500 * i) + "S" + std::to_string(480 + i) + "M12I"
+                + std::to_string(20 + i) + "M5D300M" + std::to_string(500 * (amount_segments - i)) + "S,"
+                + std::to_string(i % 61) + "," + std::to_string(i * 7) + ";";
+    }
+    return sa_tag;
+}
+
+void retrieve_aligned_segments_from_sa_tag(benchmark::State & state)
+{
+    std::string const sa_tag = generate_sa_tag(state.range(0));
+    std::vector<AlignedSegment> aligned_segments{};
+
+    for (auto _ : state)
+    {
+        aligned_segments.clear();
+        retrieve_aligned_segments(sa_tag, aligned_segments);
+        benchmark::DoNotOptimize(aligned_segments.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * sa_tag.size());
+}
+
+BENCHMARK(retrieve_aligned_segments_from_sa_tag)->Arg(1)->Arg(4)->Arg(32);